@@ -0,0 +1,388 @@
+/**********************************************************************************************
+ *
+ *   Asset Cache - Decoded images and generated meshes kept on disk
+ *
+ *   See asset_cache.h for how entries are keyed and invalidated.
+ *
+ **********************************************************************************************/
+
+#include "asset_cache.h"
+#include "asset_pack.h"
+#include "mesh_gen.h"
+#include <stdio.h>
+#include <string.h>
+
+#if !defined(PLATFORM_WEB)
+#include <pthread.h>
+#if defined(_WIN32)
+#include <direct.h>
+#define MakeCacheDirectory() _mkdir(ASSET_CACHE_DIRECTORY)
+#else
+#include <sys/stat.h>
+#define MakeCacheDirectory() mkdir(ASSET_CACHE_DIRECTORY, 0755)
+#endif
+#define ASSET_CACHE_DISK
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define ASSET_CACHE_MAGIC "RCCH"
+
+// Which optional arrays a cached mesh carries
+#define MESH_ARRAY_TEXCOORDS 0x1
+#define MESH_ARRAY_NORMALS 0x2
+#define MESH_ARRAY_INDICES 0x4
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum CacheKind {
+  CACHE_KIND_IMAGE = 1,
+  CACHE_KIND_CUBE_MESH,
+  CACHE_KIND_SPHERE_MESH,
+} CacheKind;
+
+// File header, followed by dataSize bytes of raw arrays in native byte order:
+// image pixels, mip levels back to back, or mesh vertices, texcoords,
+// normals and indices
+typedef struct CacheHeader {
+  char magic[4];
+  unsigned int version;
+  unsigned long long key; // Must match the file name, guards against renames
+  unsigned int kind;
+  int values[4];          // Image: width, height, mipmaps, format
+                          // Mesh: vertexCount, triangleCount, arrays, 0
+  unsigned int dataSize;
+} CacheHeader;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static bool cacheEnabled = true;
+
+#if defined(ASSET_CACHE_DISK)
+static pthread_mutex_t writeMutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static unsigned long long HashBytes(unsigned long long hash, const void *data,
+                                    size_t size);
+static unsigned long long MeshKey(CacheKind kind, const float *params,
+                                  int paramCount);
+static Mesh LoadCachedMesh(CacheKind kind, const float *params,
+                           int paramCount);
+static int GetImageDataSize(Image image);
+static int GetMeshDataSize(Mesh mesh, int arrays);
+static void GetCachePath(unsigned long long key, char *path, int pathSize);
+static bool ReadCacheFile(unsigned long long key, CacheKind kind,
+                          CacheHeader *header, void **data);
+static void WriteCacheFile(unsigned long long key, CacheKind kind,
+                           const int *values, const void *const *blocks,
+                           const int *blockSizes, int blockCount);
+
+//----------------------------------------------------------------------------------
+// Asset Cache Functions Definition
+//----------------------------------------------------------------------------------
+
+void SetAssetCacheEnabled(bool enabled) { cacheEnabled = enabled; }
+
+bool IsAssetCacheEnabled(void) { return cacheEnabled; }
+
+Image LoadCachedImage(const char *fileName) {
+  if (!cacheEnabled)
+    return LoadPackedImage(fileName);
+
+  // Source bytes, mapped from the pack or read from disk, are both the key
+  // and, on a miss, the input to the decoder
+  int dataSize = 0;
+  unsigned char *fileData = NULL;
+  const unsigned char *data = GetPackedFile(fileName, &dataSize);
+  if (data == NULL) {
+    fileData = LoadFileData(fileName, &dataSize);
+    data = fileData;
+  }
+  if (data == NULL)
+    return (Image){0};
+
+  const char *extension = GetFileExtension(fileName);
+  unsigned int version = ASSET_CACHE_VERSION;
+  unsigned int kind = CACHE_KIND_IMAGE;
+  unsigned long long key = 14695981039346656037ull; // FNV-1a
+  key = HashBytes(key, &version, sizeof(version));
+  key = HashBytes(key, &kind, sizeof(kind));
+  key = HashBytes(key, extension, strlen(extension));
+  key = HashBytes(key, data, (size_t)dataSize);
+
+  Image image = {0};
+  CacheHeader header = {0};
+  void *pixels = NULL;
+  if (ReadCacheFile(key, CACHE_KIND_IMAGE, &header, &pixels)) {
+    image.data = pixels;
+    image.width = header.values[0];
+    image.height = header.values[1];
+    image.mipmaps = header.values[2];
+    image.format = header.values[3];
+    if ((int)header.dataSize == GetImageDataSize(image)) {
+      UnloadFileData(fileData);
+      return image;
+    }
+    MemFree(pixels);
+  }
+
+  image = LoadImageFromMemory(extension, data, dataSize);
+  UnloadFileData(fileData);
+
+  if (image.data != NULL) {
+    int values[4] = {image.width, image.height, image.mipmaps, image.format};
+    const void *blocks[1] = {image.data};
+    int blockSizes[1] = {GetImageDataSize(image)};
+    WriteCacheFile(key, CACHE_KIND_IMAGE, values, blocks, blockSizes, 1);
+  }
+
+  return image;
+}
+
+Mesh LoadCachedCubeMesh(float width, float height, float length) {
+  const float params[3] = {width, height, length};
+  return LoadCachedMesh(CACHE_KIND_CUBE_MESH, params, 3);
+}
+
+Mesh LoadCachedSphereMesh(float radius, int rings, int slices) {
+  const float params[3] = {radius, (float)rings, (float)slices};
+  return LoadCachedMesh(CACHE_KIND_SPHERE_MESH, params, 3);
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+static unsigned long long HashBytes(unsigned long long hash, const void *data,
+                                    size_t size) {
+  const unsigned char *bytes = data;
+
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+
+  return hash;
+}
+
+static unsigned long long MeshKey(CacheKind kind, const float *params,
+                                  int paramCount) {
+  unsigned int version = ASSET_CACHE_VERSION;
+  unsigned int genVersion = MESH_GEN_VERSION; // Generator output changes too
+  unsigned int kindValue = kind;
+  unsigned long long key = 14695981039346656037ull; // FNV-1a
+
+  key = HashBytes(key, &version, sizeof(version));
+  key = HashBytes(key, &genVersion, sizeof(genVersion));
+  key = HashBytes(key, &kindValue, sizeof(kindValue));
+  key = HashBytes(key, params, sizeof(float) * paramCount);
+
+  return key;
+}
+
+static Mesh LoadCachedMesh(CacheKind kind, const float *params,
+                           int paramCount) {
+  unsigned long long key = MeshKey(kind, params, paramCount);
+  CacheHeader header = {0};
+  void *data = NULL;
+
+  if (cacheEnabled && ReadCacheFile(key, kind, &header, &data)) {
+    Mesh mesh = {0};
+    mesh.vertexCount = header.values[0];
+    mesh.triangleCount = header.values[1];
+    int arrays = header.values[2];
+
+    // Split the one block back into the separately freed arrays Mesh wants
+    if ((mesh.vertexCount > 0) && (mesh.vertexCount <= 65536) &&
+        (mesh.triangleCount >= 0) &&
+        ((int)header.dataSize == GetMeshDataSize(mesh, arrays))) {
+      const unsigned char *next = data;
+      int size = (int)sizeof(float) * 3 * mesh.vertexCount;
+      mesh.vertices = MemAlloc(size);
+      memcpy(mesh.vertices, next, size);
+      next += size;
+      if (arrays & MESH_ARRAY_TEXCOORDS) {
+        size = (int)sizeof(float) * 2 * mesh.vertexCount;
+        mesh.texcoords = MemAlloc(size);
+        memcpy(mesh.texcoords, next, size);
+        next += size;
+      }
+      if (arrays & MESH_ARRAY_NORMALS) {
+        size = (int)sizeof(float) * 3 * mesh.vertexCount;
+        mesh.normals = MemAlloc(size);
+        memcpy(mesh.normals, next, size);
+        next += size;
+      }
+      if (arrays & MESH_ARRAY_INDICES) {
+        size = (int)sizeof(unsigned short) * 3 * mesh.triangleCount;
+        mesh.indices = MemAlloc(size);
+        memcpy(mesh.indices, next, size);
+      }
+      MemFree(data);
+      return mesh;
+    }
+    MemFree(data);
+  }
+
+  Mesh mesh = (kind == CACHE_KIND_CUBE_MESH)
+                  ? GenCubeMeshData(params[0], params[1], params[2])
+                  : GenSphereMeshData(params[0], (int)params[1],
+                                      (int)params[2]);
+
+  if (cacheEnabled) {
+    int arrays = ((mesh.texcoords != NULL) ? MESH_ARRAY_TEXCOORDS : 0) |
+                 ((mesh.normals != NULL) ? MESH_ARRAY_NORMALS : 0) |
+                 ((mesh.indices != NULL) ? MESH_ARRAY_INDICES : 0);
+    int values[4] = {mesh.vertexCount, mesh.triangleCount, arrays, 0};
+    const void *blocks[4] = {mesh.vertices, mesh.texcoords, mesh.normals,
+                             mesh.indices};
+    int blockSizes[4] = {
+        (int)sizeof(float) * 3 * mesh.vertexCount,
+        (mesh.texcoords != NULL) ? (int)sizeof(float) * 2 * mesh.vertexCount
+                                 : 0,
+        (mesh.normals != NULL) ? (int)sizeof(float) * 3 * mesh.vertexCount : 0,
+        (mesh.indices != NULL)
+            ? (int)sizeof(unsigned short) * 3 * mesh.triangleCount
+            : 0};
+    WriteCacheFile(key, kind, values, blocks, blockSizes, 4);
+  }
+
+  return mesh;
+}
+
+// All mip levels, as they are stored back to back in Image.data
+static int GetImageDataSize(Image image) {
+  int size = 0;
+  int width = image.width;
+  int height = image.height;
+
+  if ((width <= 0) || (height <= 0) || (image.mipmaps <= 0))
+    return -1;
+
+  for (int level = 0; level < image.mipmaps; level++) {
+    size += GetPixelDataSize(width, height, image.format);
+    width = (width > 1) ? width / 2 : 1;
+    height = (height > 1) ? height / 2 : 1;
+  }
+
+  return size;
+}
+
+static int GetMeshDataSize(Mesh mesh, int arrays) {
+  int size = (int)sizeof(float) * 3 * mesh.vertexCount;
+
+  if (arrays & MESH_ARRAY_TEXCOORDS)
+    size += (int)sizeof(float) * 2 * mesh.vertexCount;
+  if (arrays & MESH_ARRAY_NORMALS)
+    size += (int)sizeof(float) * 3 * mesh.vertexCount;
+  if (arrays & MESH_ARRAY_INDICES)
+    size += (int)sizeof(unsigned short) * 3 * mesh.triangleCount;
+
+  return size;
+}
+
+static void GetCachePath(unsigned long long key, char *path, int pathSize) {
+  snprintf(path, pathSize, "%s/%016llx.bin", ASSET_CACHE_DIRECTORY, key);
+}
+
+// Header checked against the expected key and kind, data allocated with
+// MemAlloc(); any mismatch or short read counts as a miss
+static bool ReadCacheFile(unsigned long long key, CacheKind kind,
+                          CacheHeader *header, void **data) {
+#if defined(ASSET_CACHE_DISK)
+  char path[64];
+  GetCachePath(key, path, sizeof(path));
+
+  FILE *file = fopen(path, "rb");
+  if (file == NULL)
+    return false;
+
+  bool valid = (fread(header, sizeof(CacheHeader), 1, file) == 1) &&
+               (memcmp(header->magic, ASSET_CACHE_MAGIC, 4) == 0) &&
+               (header->version == ASSET_CACHE_VERSION) &&
+               (header->key == key) && (header->kind == (unsigned int)kind) &&
+               (header->dataSize > 0) && (header->dataSize < 0x7fffffffu);
+  if (valid) {
+    *data = MemAlloc(header->dataSize);
+    valid = (fread(*data, header->dataSize, 1, file) == 1) &&
+            (fgetc(file) == EOF);
+    if (!valid) {
+      MemFree(*data);
+      *data = NULL;
+    }
+  }
+  fclose(file);
+
+  if (valid)
+    TraceLog(LOG_DEBUG, "CACHE: [%s] Hit", path);
+  return valid;
+#else
+  (void)key;
+  (void)kind;
+  (void)header;
+  (void)data;
+  return false;
+#endif
+}
+
+// Written to a temporary file first, then renamed over the final name
+static void WriteCacheFile(unsigned long long key, CacheKind kind,
+                           const int *values, const void *const *blocks,
+                           const int *blockSizes, int blockCount) {
+#if defined(ASSET_CACHE_DISK)
+  CacheHeader header = {0};
+  memcpy(header.magic, ASSET_CACHE_MAGIC, 4);
+  header.version = ASSET_CACHE_VERSION;
+  header.key = key;
+  header.kind = kind;
+  memcpy(header.values, values, sizeof(header.values));
+  for (int i = 0; i < blockCount; i++)
+    header.dataSize += (unsigned int)blockSizes[i];
+
+  char path[64];
+  char tempPath[72];
+  GetCachePath(key, path, sizeof(path));
+  snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+
+  // The loader thread and the main thread may both miss at once
+  pthread_mutex_lock(&writeMutex);
+  MakeCacheDirectory(); // Fails harmlessly when it already exists
+
+  FILE *file = fopen(tempPath, "wb");
+  bool written = (file != NULL) &&
+                 (fwrite(&header, sizeof(header), 1, file) == 1);
+  for (int i = 0; written && (i < blockCount); i++)
+    written = (blockSizes[i] == 0) ||
+              (fwrite(blocks[i], blockSizes[i], 1, file) == 1);
+  if ((file != NULL) && (fclose(file) != 0))
+    written = false;
+
+  // NOTE: rename() does not replace an existing file on Windows, so clear
+  // the way; a reader racing this only sees a miss
+  if (written) {
+    remove(path);
+    written = (rename(tempPath, path) == 0);
+  }
+  if (!written) {
+    remove(tempPath);
+    TraceLog(LOG_WARNING, "CACHE: [%s] Failed to write cache entry", path);
+  } else {
+    TraceLog(LOG_DEBUG, "CACHE: [%s] Written (%u bytes)", path,
+             header.dataSize);
+  }
+  pthread_mutex_unlock(&writeMutex);
+#else
+  (void)key;
+  (void)kind;
+  (void)values;
+  (void)blocks;
+  (void)blockSizes;
+  (void)blockCount;
+#endif
+}
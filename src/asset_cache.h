@@ -0,0 +1,52 @@
+/**********************************************************************************************
+ *
+ *   Asset Cache - Decoded images and generated meshes kept on disk
+ *
+ *   LoadCachedImage() and LoadCachedCubeMesh()/LoadCachedSphereMesh() return
+ *   the same CPU-side data as decoding or generating it, but the first run
+ *   also writes that data raw to ASSET_CACHE_DIRECTORY, and later runs read
+ *   it straight back: pixels in their upload format, vertex arrays as
+ *   UploadMesh() takes them.
+ *
+ *   A cache file is named after a 64-bit key hashed from the cache format
+ *   version, the asset kind, the generation parameters and, for meshes,
+ *   MESH_GEN_VERSION or, for images, the bytes of the source file (packed or
+ *   loose). Editing a source, the mesh generator or a parameter therefore
+ *   changes the key and misses; stale files are never read again, deleting
+ *   the directory is always safe. Files are written to a temporary name and
+ *   renamed, so an interrupted run cannot leave a truncated entry behind.
+ *
+ *   Safe to call from the asset loader thread. Web builds never cache.
+ *
+ **********************************************************************************************/
+
+#ifndef ASSET_CACHE_H
+#define ASSET_CACHE_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define ASSET_CACHE_DIRECTORY "cache"
+#define ASSET_CACHE_VERSION 1 // Bump when a cache file layout changes
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//----------------------------------------------------------------------------------
+// Asset Cache Functions Declaration
+//----------------------------------------------------------------------------------
+void SetAssetCacheEnabled(bool enabled); // Disabled: decode and generate only
+bool IsAssetCacheEnabled(void);
+
+Image LoadCachedImage(const char *fileName); // Source from the pack if open
+Mesh LoadCachedCubeMesh(float width, float height, float length);
+Mesh LoadCachedSphereMesh(float radius, int rings, int slices);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ASSET_CACHE_H
@@ -0,0 +1,368 @@
+/**********************************************************************************************
+ *
+ *   Asset Loader - Background decoding with budgeted GPU uploads
+ *
+ *   See asset_loader.h for which side of the upload runs where.
+ *
+ **********************************************************************************************/
+
+#include "asset_loader.h"
+#include "asset_cache.h"
+#include "mesh_gen.h"
+#include "resource_tracker.h"
+#include <string.h>
+
+#if !defined(PLATFORM_WEB)
+#include <pthread.h>
+#define ASSET_LOADER_THREADED
+#endif
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum AssetKind {
+  ASSET_KIND_TEXTURE = 0,
+  ASSET_KIND_CUBE_MODEL,
+  ASSET_KIND_SPHERE_MODEL,
+} AssetKind;
+
+// FREE -> QUEUED -> DECODING (loader thread) -> DECODED -> UPLOADED -> FREE
+typedef enum AssetState {
+  ASSET_STATE_FREE = 0,
+  ASSET_STATE_QUEUED,
+  ASSET_STATE_DECODING,
+  ASSET_STATE_DECODED,
+  ASSET_STATE_UPLOADED,
+} AssetState;
+
+typedef struct AssetRequest {
+  AssetState state;
+  AssetKind kind;
+  unsigned int sequence; // Requests are decoded and uploaded in this order
+  char fileName[256];
+  float params[3];
+
+  // CPU side, written by the loader thread
+  Image image;
+  Mesh mesh;
+
+  // GPU side, written by the main thread
+  Texture2D texture;
+  Model model;
+} AssetRequest;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static AssetRequest requests[MAX_ASSET_REQUESTS] = {0};
+static unsigned int nextSequence = 0;
+
+#if defined(ASSET_LOADER_THREADED)
+static pthread_t loaderThread;
+static pthread_mutex_t requestMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t requestQueued = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t requestDecoded = PTHREAD_COND_INITIALIZER;
+static bool loaderRunning = false;
+static bool quitLoader = false;
+#endif
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static AssetHandle QueueRequest(AssetKind kind, const char *fileName,
+                                float p0, float p1, float p2);
+static void DecodeRequest(AssetRequest *request);
+static void UploadRequest(AssetRequest *request);
+static void WaitForDecode(AssetHandle handle);
+static int FindNextRequest(AssetState state);
+static void LockRequests(void);
+static void UnlockRequests(void);
+#if defined(ASSET_LOADER_THREADED)
+static void *LoaderMain(void *arg);
+#endif
+
+//----------------------------------------------------------------------------------
+// Asset Loader Functions Definition
+//----------------------------------------------------------------------------------
+
+void InitAssetLoader(void) {
+#if defined(ASSET_LOADER_THREADED)
+  if (loaderRunning)
+    return;
+
+  quitLoader = false;
+  loaderRunning = (pthread_create(&loaderThread, NULL, LoaderMain, NULL) == 0);
+  if (!loaderRunning)
+    TraceLog(LOG_WARNING, "ASSETS: Failed to start loader thread, "
+                          "loading synchronously");
+#endif
+}
+
+void UnloadAssetLoader(void) {
+#if defined(ASSET_LOADER_THREADED)
+  if (loaderRunning) {
+    LockRequests();
+    quitLoader = true;
+    pthread_cond_broadcast(&requestQueued);
+    UnlockRequests();
+    pthread_join(loaderThread, NULL);
+    loaderRunning = false;
+  }
+#endif
+
+  // Everything the loader thread could touch is settled now
+  for (int i = 0; i < MAX_ASSET_REQUESTS; i++) {
+    AssetRequest *request = &requests[i];
+
+    if (request->state == ASSET_STATE_DECODED) {
+      if (request->kind == ASSET_KIND_TEXTURE)
+        UnloadImage(request->image);
+      else
+        FreeMeshData(request->mesh);
+    } else if (request->state == ASSET_STATE_UPLOADED) {
+      if (request->kind == ASSET_KIND_TEXTURE)
+        UnloadTexture(request->texture);
+      else
+        UnloadModel(request->model);
+    }
+    *request = (AssetRequest){0};
+  }
+}
+
+AssetHandle RequestTextureAsset(const char *fileName) {
+  return QueueRequest(ASSET_KIND_TEXTURE, fileName, 0.0f, 0.0f, 0.0f);
+}
+
+AssetHandle RequestCubeModelAsset(float width, float height, float length) {
+  return QueueRequest(ASSET_KIND_CUBE_MODEL, NULL, width, height, length);
+}
+
+AssetHandle RequestSphereModelAsset(float radius, int rings, int slices) {
+  return QueueRequest(ASSET_KIND_SPHERE_MODEL, NULL, radius, (float)rings,
+                      (float)slices);
+}
+
+void UpdateAssetLoader(double budget) {
+  double start = GetTime();
+
+  // At least one upload per call, so a budget smaller than a single upload
+  // still makes progress
+  do {
+    LockRequests();
+    int next = FindNextRequest(ASSET_STATE_DECODED);
+    UnlockRequests();
+    if (next < 0)
+      break;
+
+    UploadRequest(&requests[next]);
+  } while (GetTime() - start < budget);
+}
+
+int GetPendingAssetCount(void) {
+  int pending = 0;
+
+  LockRequests();
+  for (int i = 0; i < MAX_ASSET_REQUESTS; i++) {
+    AssetState state = requests[i].state;
+    if ((state != ASSET_STATE_FREE) && (state != ASSET_STATE_UPLOADED))
+      pending++;
+  }
+  UnlockRequests();
+
+  return pending;
+}
+
+Texture2D TakeTextureAsset(AssetHandle handle) {
+  Texture2D texture = {0};
+
+  if ((handle < 0) || (handle >= MAX_ASSET_REQUESTS) ||
+      (requests[handle].kind != ASSET_KIND_TEXTURE))
+    return texture;
+
+  WaitForDecode(handle);
+  if (requests[handle].state == ASSET_STATE_DECODED)
+    UploadRequest(&requests[handle]);
+
+  // Tracked once taken, by the owner taking it
+  texture = TrackTexture(requests[handle].texture, requests[handle].fileName);
+  LockRequests();
+  requests[handle] = (AssetRequest){0};
+  UnlockRequests();
+
+  return texture;
+}
+
+Model TakeModelAsset(AssetHandle handle) {
+  Model model = {0};
+
+  if ((handle < 0) || (handle >= MAX_ASSET_REQUESTS) ||
+      (requests[handle].kind == ASSET_KIND_TEXTURE))
+    return model;
+
+  WaitForDecode(handle);
+  if (requests[handle].state == ASSET_STATE_DECODED)
+    UploadRequest(&requests[handle]);
+
+  model = TrackModel(requests[handle].model,
+                     (requests[handle].kind == ASSET_KIND_CUBE_MODEL)
+                         ? "cube mesh"
+                         : "sphere mesh");
+  LockRequests();
+  requests[handle] = (AssetRequest){0};
+  UnlockRequests();
+
+  return model;
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+static AssetHandle QueueRequest(AssetKind kind, const char *fileName,
+                                float p0, float p1, float p2) {
+  LockRequests();
+  int handle = ASSET_HANDLE_INVALID;
+  for (int i = 0; i < MAX_ASSET_REQUESTS; i++) {
+    if (requests[i].state == ASSET_STATE_FREE) {
+      handle = i;
+      break;
+    }
+  }
+  if (handle == ASSET_HANDLE_INVALID) {
+    UnlockRequests();
+    TraceLog(LOG_WARNING, "ASSETS: Too many requests in flight (max %d)",
+             MAX_ASSET_REQUESTS);
+    return ASSET_HANDLE_INVALID;
+  }
+
+  AssetRequest *request = &requests[handle];
+  *request = (AssetRequest){0};
+  request->kind = kind;
+  request->sequence = nextSequence++;
+  if (fileName != NULL)
+    strncpy(request->fileName, fileName, sizeof(request->fileName) - 1);
+  request->params[0] = p0;
+  request->params[1] = p1;
+  request->params[2] = p2;
+
+#if defined(ASSET_LOADER_THREADED)
+  if (loaderRunning) {
+    request->state = ASSET_STATE_QUEUED;
+    pthread_cond_signal(&requestQueued);
+    UnlockRequests();
+    return handle;
+  }
+#endif
+
+  // No loader thread, decode right here
+  request->state = ASSET_STATE_DECODING;
+  UnlockRequests();
+  DecodeRequest(request);
+  request->state = ASSET_STATE_DECODED;
+
+  return handle;
+}
+
+// CPU-only work, safe on the loader thread
+static void DecodeRequest(AssetRequest *request) {
+  switch (request->kind) {
+  case ASSET_KIND_TEXTURE:
+    request->image = LoadCachedImage(request->fileName);
+    break;
+  case ASSET_KIND_CUBE_MODEL:
+    request->mesh = LoadCachedCubeMesh(request->params[0], request->params[1],
+                                       request->params[2]);
+    break;
+  case ASSET_KIND_SPHERE_MODEL:
+    request->mesh = LoadCachedSphereMesh(request->params[0],
+                                         (int)request->params[1],
+                                         (int)request->params[2]);
+    break;
+  default:
+    break;
+  }
+}
+
+// GPU work, main thread only
+static void UploadRequest(AssetRequest *request) {
+  if (request->kind == ASSET_KIND_TEXTURE) {
+    request->texture = LoadTextureFromImage(request->image);
+    UnloadImage(request->image);
+    request->image = (Image){0};
+  } else {
+    UploadMesh(&request->mesh, false);
+    request->model = LoadModelFromMesh(request->mesh);
+    request->mesh = (Mesh){0};
+  }
+
+  LockRequests();
+  request->state = ASSET_STATE_UPLOADED;
+  UnlockRequests();
+}
+
+static void WaitForDecode(AssetHandle handle) {
+#if defined(ASSET_LOADER_THREADED)
+  LockRequests();
+  while ((requests[handle].state == ASSET_STATE_QUEUED) ||
+         (requests[handle].state == ASSET_STATE_DECODING))
+    pthread_cond_wait(&requestDecoded, &requestMutex);
+  UnlockRequests();
+#else
+  (void)handle;
+#endif
+}
+
+// Oldest request in the given state, or -1
+// NOTE: Called with the requests locked
+static int FindNextRequest(AssetState state) {
+  int next = -1;
+
+  for (int i = 0; i < MAX_ASSET_REQUESTS; i++) {
+    if ((requests[i].state == state) &&
+        ((next < 0) ||
+         ((int)(requests[i].sequence - requests[next].sequence) < 0)))
+      next = i;
+  }
+
+  return next;
+}
+
+static void LockRequests(void) {
+#if defined(ASSET_LOADER_THREADED)
+  pthread_mutex_lock(&requestMutex);
+#endif
+}
+
+static void UnlockRequests(void) {
+#if defined(ASSET_LOADER_THREADED)
+  pthread_mutex_unlock(&requestMutex);
+#endif
+}
+
+#if defined(ASSET_LOADER_THREADED)
+static void *LoaderMain(void *arg) {
+  (void)arg;
+
+  LockRequests();
+  while (!quitLoader) {
+    int next = FindNextRequest(ASSET_STATE_QUEUED);
+    if (next < 0) {
+      pthread_cond_wait(&requestQueued, &requestMutex);
+      continue;
+    }
+
+    AssetRequest *request = &requests[next];
+    request->state = ASSET_STATE_DECODING;
+    UnlockRequests();
+
+    DecodeRequest(request);
+
+    LockRequests();
+    request->state = ASSET_STATE_DECODED;
+    pthread_cond_broadcast(&requestDecoded);
+  }
+  UnlockRequests();
+
+  return NULL;
+}
+#endif
@@ -0,0 +1,59 @@
+/**********************************************************************************************
+ *
+ *   Asset Loader - Background decoding with budgeted GPU uploads
+ *
+ *   Request*Asset() queues work and returns at once. A loader thread reads
+ *   and decodes image files, from the asset pack when one is open, and
+ *   generates mesh data, both through the asset cache; UpdateAssetLoader(),
+ *   called once per frame on the main thread, uploads finished assets to the
+ *   GPU until its time budget runs out. Take*Asset() hands the result over
+ *   to the caller, finishing the load on the spot if it is still pending,
+ *   so code that does not wait for the loader stays correct, just slower.
+ *
+ *   Without InitAssetLoader(), and on web builds, requests are decoded
+ *   synchronously when they are made.
+ *
+ **********************************************************************************************/
+
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define MAX_ASSET_REQUESTS 64 // Room for a scenario's rock models
+#define ASSET_HANDLE_INVALID -1
+#define ASSET_UPLOAD_BUDGET 0.004 // Seconds of uploads per frame
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef int AssetHandle;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//----------------------------------------------------------------------------------
+// Asset Loader Functions Declaration
+//----------------------------------------------------------------------------------
+void InitAssetLoader(void);   // Starts the loader thread
+void UnloadAssetLoader(void); // Stops it, unloads whatever was not taken
+
+AssetHandle RequestTextureAsset(const char *fileName);
+AssetHandle RequestCubeModelAsset(float width, float height, float length);
+AssetHandle RequestSphereModelAsset(float radius, int rings, int slices);
+
+void UpdateAssetLoader(double budget); // Upload decoded assets, main thread
+int GetPendingAssetCount(void);        // Requests not uploaded yet
+
+Texture2D TakeTextureAsset(AssetHandle handle); // Caller unloads the result
+Model TakeModelAsset(AssetHandle handle);       // Caller unloads the result
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ASSET_LOADER_H
@@ -0,0 +1,245 @@
+/**********************************************************************************************
+ *
+ *   Asset Pack - Single-file asset archive, memory-mapped at runtime
+ *
+ *   See asset_pack.h for the file layout.
+ *
+ **********************************************************************************************/
+
+#include "asset_pack.h"
+#include <string.h>
+
+#if !defined(_WIN32) && !defined(PLATFORM_WEB)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ASSET_PACK_MMAP
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static const unsigned char *packData = NULL; // Mapped (or read) pack file
+static size_t packSize = 0;
+static const AssetPackHeader *header = NULL;
+static const unsigned int *buckets = NULL;
+static const AssetPackEntry *entries = NULL;
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static bool ValidatePack(void);
+
+//----------------------------------------------------------------------------------
+// Asset Pack Functions Definition
+//----------------------------------------------------------------------------------
+
+bool OpenAssetPack(const char *fileName) {
+  if (packData != NULL)
+    CloseAssetPack();
+
+#if defined(ASSET_PACK_MMAP)
+  int fd = open(fileName, O_RDONLY);
+  if (fd < 0) {
+    TraceLog(LOG_INFO, "PACK: [%s] Not found, using loose files", fileName);
+    return false;
+  }
+
+  struct stat info;
+  if ((fstat(fd, &info) == 0) && (info.st_size > 0)) {
+    void *mapping =
+        mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping != MAP_FAILED) {
+      packData = mapping;
+      packSize = (size_t)info.st_size;
+    }
+  }
+  close(fd); // The mapping stays valid without the descriptor
+#else
+  // NOTE: No mmap here, read the pack once and serve views into the copy
+  int dataSize = 0;
+  if (FileExists(fileName)) {
+    packData = LoadFileData(fileName, &dataSize);
+    packSize = (size_t)dataSize;
+  }
+#endif
+
+  if (packData == NULL) {
+    TraceLog(LOG_INFO, "PACK: [%s] Not available, using loose files",
+             fileName);
+    return false;
+  }
+  if (!ValidatePack()) {
+    TraceLog(LOG_WARNING, "PACK: [%s] Invalid pack, using loose files",
+             fileName);
+    CloseAssetPack();
+    return false;
+  }
+
+  TraceLog(LOG_INFO, "PACK: [%s] Mapped %d entries (%d bytes)", fileName,
+           (int)header->entryCount, (int)packSize);
+  return true;
+}
+
+void CloseAssetPack(void) {
+  if (packData == NULL)
+    return;
+
+#if defined(ASSET_PACK_MMAP)
+  munmap((void *)packData, packSize);
+#else
+  UnloadFileData((unsigned char *)packData);
+#endif
+
+  packData = NULL;
+  packSize = 0;
+  header = NULL;
+  buckets = NULL;
+  entries = NULL;
+}
+
+bool IsAssetPackOpen(void) { return packData != NULL; }
+
+const char *NormalizeAssetName(const char *fileName) {
+  while ((fileName[0] == '.') && (fileName[1] == '/'))
+    fileName += 2;
+
+  return fileName;
+}
+
+unsigned int HashAssetName(const char *name) {
+  unsigned int hash = 2166136261u; // FNV-1a
+
+  for (const unsigned char *c = (const unsigned char *)name; *c != '\0'; c++) {
+    hash ^= *c;
+    hash *= 16777619u;
+  }
+
+  return hash;
+}
+
+const unsigned char *GetPackedFile(const char *fileName, int *dataSize) {
+  if (packData == NULL)
+    return NULL;
+
+  const char *name = NormalizeAssetName(fileName);
+  unsigned int hash = HashAssetName(name);
+  unsigned int index = buckets[hash & (header->bucketCount - 1)];
+
+  while (index != ASSET_PACK_NONE) {
+    const AssetPackEntry *entry = &entries[index];
+    if ((entry->nameHash == hash) &&
+        (strcmp((const char *)packData + entry->nameOffset, name) == 0)) {
+      if (dataSize != NULL)
+        *dataSize = (int)entry->dataSize;
+      return packData + entry->dataOffset;
+    }
+    index = entry->nextEntry;
+  }
+
+  return NULL;
+}
+
+Image LoadPackedImage(const char *fileName) {
+  int dataSize = 0;
+  const unsigned char *data = GetPackedFile(fileName, &dataSize);
+
+  if (data == NULL)
+    return LoadImage(fileName);
+
+  return LoadImageFromMemory(GetFileExtension(fileName), data, dataSize);
+}
+
+// Same as LoadFont() for image fonts; other formats are not packed
+Font LoadPackedFont(const char *fileName) {
+  if (!IsFileExtension(fileName, ".png") ||
+      (GetPackedFile(fileName, NULL) == NULL))
+    return LoadFont(fileName);
+
+  Font font = GetFontDefault();
+  Image image = LoadPackedImage(fileName);
+  if (image.data != NULL)
+    font = LoadFontFromImage(image, MAGENTA, 32);
+  UnloadImage(image);
+
+  return font;
+}
+
+Sound LoadPackedSound(const char *fileName) {
+  int dataSize = 0;
+  const unsigned char *data = GetPackedFile(fileName, &dataSize);
+
+  if (data == NULL)
+    return LoadSound(fileName);
+
+  Wave wave = LoadWaveFromMemory(GetFileExtension(fileName), data, dataSize);
+  Sound sound = LoadSoundFromWave(wave);
+  UnloadWave(wave);
+
+  return sound;
+}
+
+Music LoadPackedMusicStream(const char *fileName) {
+  int dataSize = 0;
+  const unsigned char *data = GetPackedFile(fileName, &dataSize);
+
+  if (data == NULL)
+    return LoadMusicStream(fileName);
+
+  return LoadMusicStreamFromMemory(GetFileExtension(fileName), data,
+                                   dataSize);
+}
+
+Shader LoadPackedShader(const char *vsFileName, const char *fsFileName) {
+  const char *vsCode = (const char *)GetPackedFile(vsFileName, NULL);
+  const char *fsCode = (const char *)GetPackedFile(fsFileName, NULL);
+
+  if ((vsCode == NULL) || (fsCode == NULL))
+    return LoadShader(vsFileName, fsFileName);
+
+  return LoadShaderFromMemory(vsCode, fsCode);
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+// Bounds-check the tables once so lookups can trust every offset
+static bool ValidatePack(void) {
+  if (packSize < sizeof(AssetPackHeader))
+    return false;
+
+  header = (const AssetPackHeader *)packData;
+  if ((memcmp(header->magic, ASSET_PACK_MAGIC, 4) != 0) ||
+      (header->version != ASSET_PACK_VERSION) || (header->bucketCount == 0) ||
+      ((header->bucketCount & (header->bucketCount - 1)) != 0))
+    return false;
+
+  size_t tablesEnd = sizeof(AssetPackHeader) +
+                     sizeof(unsigned int) * (size_t)header->bucketCount +
+                     sizeof(AssetPackEntry) * (size_t)header->entryCount;
+  if (tablesEnd > packSize)
+    return false;
+
+  buckets = (const unsigned int *)(packData + sizeof(AssetPackHeader));
+  entries = (const AssetPackEntry *)(buckets + header->bucketCount);
+
+  for (unsigned int i = 0; i < header->bucketCount; i++) {
+    if ((buckets[i] != ASSET_PACK_NONE) && (buckets[i] >= header->entryCount))
+      return false;
+  }
+  for (unsigned int i = 0; i < header->entryCount; i++) {
+    const AssetPackEntry *entry = &entries[i];
+    // Chains only point to lower indices, so a lookup always terminates
+    if (((entry->nextEntry != ASSET_PACK_NONE) && (entry->nextEntry >= i)) ||
+        (entry->nameOffset >= packSize) ||
+        (memchr(packData + entry->nameOffset, '\0',
+                packSize - entry->nameOffset) == NULL) ||
+        ((size_t)entry->dataOffset + entry->dataSize + 1 > packSize) ||
+        (packData[(size_t)entry->dataOffset + entry->dataSize] != '\0'))
+      return false;
+  }
+
+  return true;
+}
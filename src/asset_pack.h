@@ -0,0 +1,87 @@
+/**********************************************************************************************
+ *
+ *   Asset Pack - Single-file asset archive, memory-mapped at runtime
+ *
+ *   `make pack` runs raylib_game_packer over the game's resources and writes
+ *   resources.pak. OpenAssetPack() maps the whole file once; the
+ *   LoadPacked*() functions look names up in its hash index and feed the
+ *   mapped bytes straight to raylib's Load*FromMemory(), without opening or
+ *   copying anything. Where mmap() is missing (Windows, web) the pack is
+ *   read into memory once instead. Names not in the pack, or every name when
+ *   no pack is open, fall back to the loose file of the same path.
+ *
+ *   Layout (native byte order, all offsets from the start of the file):
+ *
+ *       AssetPackHeader
+ *       unsigned int buckets[bucketCount]    first entry per hash bucket
+ *       AssetPackEntry entries[entryCount]   chained through nextEntry,
+ *                                            towards lower indices
+ *       names                                NUL-terminated
+ *       data                                 ASSET_PACK_ALIGNMENT aligned,
+ *                                            each followed by a NUL byte
+ *
+ *   The trailing NUL lets text assets such as shaders be used in place as C
+ *   strings.
+ *
+ *   NOTE: Music streams keep reading from the mapping, so CloseAssetPack()
+ *   must come after UnloadMusicStream() and UnloadMusicStreamer().
+ *
+ **********************************************************************************************/
+
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define ASSET_PACK_MAGIC "RPAK"
+#define ASSET_PACK_VERSION 1
+#define ASSET_PACK_ALIGNMENT 16
+#define ASSET_PACK_NONE 0xffffffffu // End of a bucket chain
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct AssetPackHeader {
+  char magic[4];
+  unsigned int version;
+  unsigned int entryCount;
+  unsigned int bucketCount; // Power of two
+} AssetPackHeader;
+
+typedef struct AssetPackEntry {
+  unsigned int nameHash; // HashAssetName() of the name
+  unsigned int nextEntry;
+  unsigned int nameOffset;
+  unsigned int dataOffset;
+  unsigned int dataSize; // Trailing NUL not included
+} AssetPackEntry;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//----------------------------------------------------------------------------------
+// Asset Pack Functions Declaration
+//----------------------------------------------------------------------------------
+bool OpenAssetPack(const char *fileName); // On failure loose files are used
+void CloseAssetPack(void);
+bool IsAssetPackOpen(void);
+const char *NormalizeAssetName(const char *fileName); // Strips leading "./"
+unsigned int HashAssetName(const char *name);
+const unsigned char *GetPackedFile(const char *fileName,
+                                   int *dataSize); // NULL if not packed
+
+Image LoadPackedImage(const char *fileName);
+Font LoadPackedFont(const char *fileName);
+Sound LoadPackedSound(const char *fileName);
+Music LoadPackedMusicStream(const char *fileName);
+Shader LoadPackedShader(const char *vsFileName, const char *fsFileName);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ASSET_PACK_H
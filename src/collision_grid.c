@@ -0,0 +1,244 @@
+/**********************************************************************************************
+ *
+ *   Collision Grid - Uniform spatial hash over the play field
+ *
+ *   See collision_grid.h for the clamping rules.
+ *
+ **********************************************************************************************/
+
+#include "collision_grid.h"
+#include "frame_arena.h"
+#include "raylib.h"
+#include "tagged_heap.h"
+#include <math.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+// Bounding squares are padded so float rounding at a cell border can never
+// leave a touching bullet in a cell the rock was not inserted into
+#define GRID_BOUNDS_PADDING 0.001f
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static float cellSize = GRID_MAX_CELL_SIZE;
+static int columns = 1;
+static int rows = 1;
+static int cellStart[GRID_MAX_CELLS + 1] = {0}; // Offsets into cellRocks
+static int cellFill[GRID_MAX_CELLS] = {0};
+static int *cellRocks = NULL;
+static int cellRocksCapacity = 0;
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static void ChooseCellSize(const EntityStore *rocks);
+static int CellColumn(float x);
+static int CellRow(float y);
+static float RandomInRange(unsigned int *rng, float min, float max);
+
+//----------------------------------------------------------------------------------
+// Collision Grid Functions Definition
+//----------------------------------------------------------------------------------
+
+void BuildCollisionGrid(const EntityStore *rocks) {
+  ChooseCellSize(rocks);
+  int cells = columns * rows;
+
+  // Count rocks per cell
+  memset(cellStart, 0, sizeof(int) * (cells + 1));
+  for (int i = 0; i < rocks->count; i++) {
+    float reach = rocks->radius[i] + GRID_BOUNDS_PADDING;
+    int c0 = CellColumn(rocks->posX[i] - reach);
+    int c1 = CellColumn(rocks->posX[i] + reach);
+    int r0 = CellRow(rocks->posY[i] - reach);
+    int r1 = CellRow(rocks->posY[i] + reach);
+    for (int r = r0; r <= r1; r++)
+      for (int c = c0; c <= c1; c++)
+        cellStart[r * columns + c + 1]++;
+  }
+
+  // Prefix sum into offsets
+  for (int cell = 0; cell < cells; cell++)
+    cellStart[cell + 1] += cellStart[cell];
+
+  int total = cellStart[cells];
+  if ((cellRocks == NULL) || (total > cellRocksCapacity)) {
+    int capacity = (cellRocksCapacity > 0) ? cellRocksCapacity : 256;
+    while (capacity < total)
+      capacity *= 2;
+    cellRocks =
+        TaggedRealloc(MEM_TAG_COLLISION, cellRocks, sizeof(int) * capacity);
+    cellRocksCapacity = capacity;
+  }
+
+  // Scatter rock indices, each cell ends up in ascending rock order
+  memcpy(cellFill, cellStart, sizeof(int) * cells);
+  for (int i = 0; i < rocks->count; i++) {
+    float reach = rocks->radius[i] + GRID_BOUNDS_PADDING;
+    int c0 = CellColumn(rocks->posX[i] - reach);
+    int c1 = CellColumn(rocks->posX[i] + reach);
+    int r0 = CellRow(rocks->posY[i] - reach);
+    int r1 = CellRow(rocks->posY[i] + reach);
+    for (int r = r0; r <= r1; r++)
+      for (int c = c0; c <= c1; c++)
+        cellRocks[cellFill[r * columns + c]++] = i;
+  }
+}
+
+const int *GetCollisionGridCell(float x, float y, int *count) {
+  int cell = CellRow(y) * columns + CellColumn(x);
+  *count = cellStart[cell + 1] - cellStart[cell];
+  return cellRocks + cellStart[cell];
+}
+
+void UnloadCollisionGrid(void) {
+  TaggedFree(cellRocks);
+  cellRocks = NULL;
+  cellRocksCapacity = 0;
+  memset(cellStart, 0, sizeof(cellStart));
+  cellSize = GRID_MAX_CELL_SIZE;
+  columns = 1;
+  rows = 1;
+}
+
+bool VerifyCollisionGrid(const EntityStore *bullets,
+                         const EntityStore *rocks) {
+  // Hits per rock and per bullet, brute force first and grid second, in
+  // frame scratch memory given back before returning
+  int numCounters = rocks->count + bullets->count;
+  size_t mark = GetFrameArenaMark();
+  int *bruteHits = FrameAllocZeroed(sizeof(int) * (numCounters + 1));
+  int *gridHits = FrameAllocZeroed(sizeof(int) * (numCounters + 1));
+  if ((bruteHits == NULL) || (gridHits == NULL)) {
+    RewindFrameArena(mark);
+    TraceLog(LOG_WARNING, "COLLISION: Scene too large to verify");
+    return true;
+  }
+
+  for (int b = 0; b < bullets->count; b++) {
+    Vector2 bulletPos = (Vector2){bullets->posX[b], bullets->posY[b]};
+    for (int r = 0; r < rocks->count; r++) {
+      if (CheckCollisionPointCircle(bulletPos,
+                                    (Vector2){rocks->posX[r], rocks->posY[r]},
+                                    rocks->radius[r])) {
+        bruteHits[r]++;
+        bruteHits[rocks->count + b]++;
+      }
+    }
+  }
+
+  BuildCollisionGrid(rocks);
+  for (int b = 0; b < bullets->count; b++) {
+    Vector2 bulletPos = (Vector2){bullets->posX[b], bullets->posY[b]};
+    int candidates = 0;
+    const int *cell =
+        GetCollisionGridCell(bulletPos.x, bulletPos.y, &candidates);
+    for (int k = 0; k < candidates; k++) {
+      int r = cell[k];
+      if (CheckCollisionPointCircle(bulletPos,
+                                    (Vector2){rocks->posX[r], rocks->posY[r]},
+                                    rocks->radius[r])) {
+        gridHits[r]++;
+        gridHits[rocks->count + b]++;
+      }
+    }
+  }
+
+  bool match =
+      (memcmp(bruteHits, gridHits, sizeof(int) * numCounters) == 0);
+  if (!match)
+    TraceLog(LOG_WARNING, "COLLISION: Grid hits differ from brute force");
+
+  RewindFrameArena(mark);
+  return match;
+}
+
+bool VerifyCollisionGridScenes(int scenes, unsigned int seed) {
+  unsigned int rng = (seed != 0) ? seed : 1; // xorshift must not be 0
+  bool passed = true;
+
+  for (int scene = 0; scene < scenes; scene++) {
+    EntityStore bullets = {0};
+    EntityStore rocks = {0};
+    InitEntityStore(&bullets, 0, MEM_TAG_BULLETS);
+    InitEntityStore(&rocks, 0, MEM_TAG_ROCKS);
+
+    int numBullets = (int)RandomInRange(&rng, 0.0f, 2000.0f);
+    int numRocks = (int)RandomInRange(&rng, 0.0f, 300.0f);
+    for (int i = 0; i < numBullets; i++) {
+      int bullet = SpawnEntity(&bullets);
+      bullets.posX[bullet] = RandomInRange(&rng, -30.0f, 30.0f);
+      bullets.posY[bullet] = RandomInRange(&rng, -20.0f, 20.0f);
+    }
+    for (int i = 0; i < numRocks; i++) {
+      int rock = SpawnEntity(&rocks);
+      rocks.posX[rock] = RandomInRange(&rng, -30.0f, 30.0f);
+      rocks.posY[rock] = RandomInRange(&rng, -20.0f, 20.0f);
+      rocks.radius[rock] = RandomInRange(&rng, 0.1f, 5.0f);
+    }
+
+    if (!VerifyCollisionGrid(&bullets, &rocks))
+      passed = false;
+
+    UnloadEntityStore(&bullets);
+    UnloadEntityStore(&rocks);
+  }
+
+  UnloadCollisionGrid();
+  return passed;
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+// xorshift32, so the scenes only depend on the seed
+static float RandomInRange(unsigned int *rng, float min, float max) {
+  *rng ^= *rng << 13;
+  *rng ^= *rng >> 17;
+  *rng ^= *rng << 5;
+  return min + (max - min) * (*rng / 4294967295.0f);
+}
+
+static void ChooseCellSize(const EntityStore *rocks) {
+  float radiusSum = 0.0f;
+  for (int i = 0; i < rocks->count; i++)
+    radiusSum += rocks->radius[i];
+
+  int count = (rocks->count > 0) ? rocks->count : 1;
+  cellSize = sqrtf(GRID_WIDTH * GRID_HEIGHT / count);
+  float minCellSize = GRID_RADIUS_CELL_RATIO * radiusSum / count;
+  if (cellSize < minCellSize)
+    cellSize = minCellSize;
+  if (!(cellSize <= GRID_MAX_CELL_SIZE))
+    cellSize = GRID_MAX_CELL_SIZE; // NOTE: Also catches NaN radii
+
+  columns = (int)ceilf(GRID_WIDTH / cellSize);
+  rows = (int)ceilf(GRID_HEIGHT / cellSize);
+  while (columns * rows > GRID_MAX_CELLS) {
+    cellSize *= 1.25f;
+    columns = (int)ceilf(GRID_WIDTH / cellSize);
+    rows = (int)ceilf(GRID_HEIGHT / cellSize);
+  }
+}
+
+static int CellColumn(float x) {
+  float column = (x - GRID_MIN_X) / cellSize;
+  if (!(column >= 0.0f))
+    return 0; // NOTE: Also catches NaN
+  if (column >= columns)
+    return columns - 1;
+  return (int)column;
+}
+
+static int CellRow(float y) {
+  float row = (y - GRID_MIN_Y) / cellSize;
+  if (!(row >= 0.0f))
+    return 0;
+  if (row >= rows)
+    return rows - 1;
+  return (int)row;
+}
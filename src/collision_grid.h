@@ -0,0 +1,55 @@
+/**********************************************************************************************
+ *
+ *   Collision Grid - Uniform spatial hash over the play field
+ *
+ *   Rocks are bucketed into every cell their bounding square overlaps, then
+ *   each bullet only runs the narrow phase against the rocks of its own cell.
+ *   Coordinates outside the play field are clamped to the border cells, for
+ *   rocks and bullets alike, so the grid reports exactly the same hits as
+ *   testing every bullet against every rock.
+ *
+ *   The grid is rebuilt from scratch every update; its storage is kept
+ *   between rebuilds. Each rebuild also picks the cell size: about one rock
+ *   per cell, never coarser than GRID_MAX_CELL_SIZE, and never finer than
+ *   GRID_RADIUS_CELL_RATIO times the mean rock radius, since finer cells
+ *   put each rock in many more cells and save few candidate tests.
+ *
+ **********************************************************************************************/
+
+#ifndef COLLISION_GRID_H
+#define COLLISION_GRID_H
+
+#include "entity_store.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define GRID_MIN_X -22.0f // Matches the g0..g3 play-field quad
+#define GRID_MIN_Y -12.0f
+#define GRID_WIDTH 44.0f
+#define GRID_HEIGHT 24.0f
+#define GRID_MAX_CELL_SIZE 4.0f // An 11x6 grid, for a handful of rocks
+#define GRID_RADIUS_CELL_RATIO 0.25f
+#define GRID_MAX_CELLS 4096
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//----------------------------------------------------------------------------------
+// Collision Grid Functions Declaration
+//----------------------------------------------------------------------------------
+void BuildCollisionGrid(const EntityStore *rocks);
+const int *GetCollisionGridCell(float x, float y,
+                                int *count); // Rock indices near a point
+void UnloadCollisionGrid(void);
+bool VerifyCollisionGrid(const EntityStore *bullets,
+                         const EntityStore *rocks); // Compare to brute force
+// Randomized scenes, partly outside the play field, against brute force
+bool VerifyCollisionGridScenes(int scenes, unsigned int seed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COLLISION_GRID_H
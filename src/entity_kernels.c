@@ -0,0 +1,292 @@
+/**********************************************************************************************
+ *
+ *   Entity Kernels - Vectorized position integration and expiry tests
+ *
+ *   See entity_kernels.h for how a kernel is selected.
+ *
+ **********************************************************************************************/
+
+#include "entity_kernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define ENTITY_KERNELS_SSE2
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define ENTITY_KERNELS_AVX2
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+// A bullet leaves once (int)(x + 20) is outside [0, 40] or (int)(y + 11)
+// outside [0, 22]. Truncation makes that x + 20 >= 41 or x + 20 <= -1,
+// which the vector kernels can test without converting to integers
+#define BULLET_OFFSET_X 20.0f
+#define BULLET_OFFSET_Y 11.0f
+#define BULLET_LIMIT_X 41.0f
+#define BULLET_LIMIT_Y 23.0f
+#define BULLET_LIMIT_MIN -1.0f
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+#if defined(ENTITY_KERNELS_AVX2)
+static EntityKernel activeKernel = ENTITY_KERNEL_AVX2;
+#elif defined(ENTITY_KERNELS_SSE2)
+static EntityKernel activeKernel = ENTITY_KERNEL_SSE2;
+#else
+static EntityKernel activeKernel = ENTITY_KERNEL_SCALAR;
+#endif
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static void IntegrateBulletsScalar(EntityStore *bullets, float dt, int begin,
+                                   int end);
+static void IntegrateRocksScalar(EntityStore *rocks, float dt, int begin,
+                                 int end);
+static void FlagDead(EntityStore *store, int first, int mask);
+#if defined(ENTITY_KERNELS_SSE2)
+static int IntegrateBulletsSSE2(EntityStore *bullets, float dt, int begin,
+                                int end);
+static int IntegrateRocksSSE2(EntityStore *rocks, float dt, int begin,
+                              int end);
+#endif
+#if defined(ENTITY_KERNELS_AVX2)
+static int IntegrateBulletsAVX2(EntityStore *bullets, float dt, int begin,
+                                int end);
+static int IntegrateRocksAVX2(EntityStore *rocks, float dt, int begin,
+                              int end);
+#endif
+
+//----------------------------------------------------------------------------------
+// Entity Kernels Functions Definition
+//----------------------------------------------------------------------------------
+
+EntityKernel GetBestEntityKernel(void) {
+#if defined(ENTITY_KERNELS_AVX2)
+  return ENTITY_KERNEL_AVX2;
+#elif defined(ENTITY_KERNELS_SSE2)
+  return ENTITY_KERNEL_SSE2;
+#else
+  return ENTITY_KERNEL_SCALAR;
+#endif
+}
+
+EntityKernel GetEntityKernel(void) { return activeKernel; }
+
+void SetEntityKernel(EntityKernel kernel) {
+  activeKernel = (kernel > GetBestEntityKernel()) ? GetBestEntityKernel()
+                                                   : kernel;
+}
+
+const char *GetEntityKernelName(EntityKernel kernel) {
+  switch (kernel) {
+  case ENTITY_KERNEL_SSE2:
+    return "sse2";
+  case ENTITY_KERNEL_AVX2:
+    return "avx2";
+  default:
+    return "scalar";
+  }
+}
+
+// Vector kernels return where they stopped; the scalar kernel takes the tail
+void IntegrateBulletRange(EntityStore *bullets, float dt, int begin, int end) {
+  switch (activeKernel) {
+#if defined(ENTITY_KERNELS_AVX2)
+  case ENTITY_KERNEL_AVX2:
+    begin = IntegrateBulletsAVX2(bullets, dt, begin, end);
+    break;
+#endif
+#if defined(ENTITY_KERNELS_SSE2)
+  case ENTITY_KERNEL_SSE2:
+    begin = IntegrateBulletsSSE2(bullets, dt, begin, end);
+    break;
+#endif
+  default:
+    break;
+  }
+
+  IntegrateBulletsScalar(bullets, dt, begin, end);
+}
+
+void IntegrateRockRange(EntityStore *rocks, float dt, int begin, int end) {
+  switch (activeKernel) {
+#if defined(ENTITY_KERNELS_AVX2)
+  case ENTITY_KERNEL_AVX2:
+    begin = IntegrateRocksAVX2(rocks, dt, begin, end);
+    break;
+#endif
+#if defined(ENTITY_KERNELS_SSE2)
+  case ENTITY_KERNEL_SSE2:
+    begin = IntegrateRocksSSE2(rocks, dt, begin, end);
+    break;
+#endif
+  default:
+    break;
+  }
+
+  IntegrateRocksScalar(rocks, dt, begin, end);
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+static void IntegrateBulletsScalar(EntityStore *bullets, float dt, int begin,
+                                   int end) {
+  for (int i = begin; i < end; i++) {
+    bullets->posX[i] += bullets->velX[i] * dt;
+    bullets->posY[i] += bullets->velY[i] * dt;
+
+    float x = bullets->posX[i] + BULLET_OFFSET_X;
+    float y = bullets->posY[i] + BULLET_OFFSET_Y;
+    if ((x >= BULLET_LIMIT_X) || (x <= BULLET_LIMIT_MIN) ||
+        (y >= BULLET_LIMIT_Y) || (y <= BULLET_LIMIT_MIN))
+      bullets->flags[i] |= ENTITY_FLAG_DEAD;
+  }
+}
+
+static void IntegrateRocksScalar(EntityStore *rocks, float dt, int begin,
+                                 int end) {
+  for (int i = begin; i < end; i++) {
+    rocks->posX[i] += rocks->velX[i] * dt;
+    rocks->posY[i] += rocks->velY[i] * dt;
+
+    rocks->lifeTime[i] -= dt;
+    if (rocks->lifeTime[i] < 0.0f)
+      rocks->flags[i] |= ENTITY_FLAG_DEAD;
+  }
+}
+
+// Flag the entities whose bit is set in a compare mask starting at first
+static void FlagDead(EntityStore *store, int first, int mask) {
+  for (int lane = 0; mask != 0; lane++, mask >>= 1) {
+    if (mask & 1)
+      store->flags[first + lane] |= ENTITY_FLAG_DEAD;
+  }
+}
+
+#if defined(ENTITY_KERNELS_SSE2)
+static int IntegrateBulletsSSE2(EntityStore *bullets, float dt, int begin,
+                                int end) {
+  const __m128 vdt = _mm_set1_ps(dt);
+  const __m128 offsetX = _mm_set1_ps(BULLET_OFFSET_X);
+  const __m128 offsetY = _mm_set1_ps(BULLET_OFFSET_Y);
+  const __m128 limitX = _mm_set1_ps(BULLET_LIMIT_X);
+  const __m128 limitY = _mm_set1_ps(BULLET_LIMIT_Y);
+  const __m128 limitMin = _mm_set1_ps(BULLET_LIMIT_MIN);
+  int i = begin;
+
+  for (; i + 4 <= end; i += 4) {
+    __m128 x = _mm_add_ps(_mm_loadu_ps(bullets->posX + i),
+                          _mm_mul_ps(_mm_loadu_ps(bullets->velX + i), vdt));
+    __m128 y = _mm_add_ps(_mm_loadu_ps(bullets->posY + i),
+                          _mm_mul_ps(_mm_loadu_ps(bullets->velY + i), vdt));
+    _mm_storeu_ps(bullets->posX + i, x);
+    _mm_storeu_ps(bullets->posY + i, y);
+
+    x = _mm_add_ps(x, offsetX);
+    y = _mm_add_ps(y, offsetY);
+    __m128 out = _mm_or_ps(
+        _mm_or_ps(_mm_cmpge_ps(x, limitX), _mm_cmple_ps(x, limitMin)),
+        _mm_or_ps(_mm_cmpge_ps(y, limitY), _mm_cmple_ps(y, limitMin)));
+    int mask = _mm_movemask_ps(out);
+    if (mask != 0)
+      FlagDead(bullets, i, mask);
+  }
+
+  return i;
+}
+
+static int IntegrateRocksSSE2(EntityStore *rocks, float dt, int begin,
+                              int end) {
+  const __m128 vdt = _mm_set1_ps(dt);
+  const __m128 zero = _mm_setzero_ps();
+  int i = begin;
+
+  for (; i + 4 <= end; i += 4) {
+    __m128 x = _mm_add_ps(_mm_loadu_ps(rocks->posX + i),
+                          _mm_mul_ps(_mm_loadu_ps(rocks->velX + i), vdt));
+    __m128 y = _mm_add_ps(_mm_loadu_ps(rocks->posY + i),
+                          _mm_mul_ps(_mm_loadu_ps(rocks->velY + i), vdt));
+    __m128 life = _mm_sub_ps(_mm_loadu_ps(rocks->lifeTime + i), vdt);
+    _mm_storeu_ps(rocks->posX + i, x);
+    _mm_storeu_ps(rocks->posY + i, y);
+    _mm_storeu_ps(rocks->lifeTime + i, life);
+
+    int mask = _mm_movemask_ps(_mm_cmplt_ps(life, zero));
+    if (mask != 0)
+      FlagDead(rocks, i, mask);
+  }
+
+  return i;
+}
+#endif
+
+#if defined(ENTITY_KERNELS_AVX2)
+static int IntegrateBulletsAVX2(EntityStore *bullets, float dt, int begin,
+                                int end) {
+  const __m256 vdt = _mm256_set1_ps(dt);
+  const __m256 offsetX = _mm256_set1_ps(BULLET_OFFSET_X);
+  const __m256 offsetY = _mm256_set1_ps(BULLET_OFFSET_Y);
+  const __m256 limitX = _mm256_set1_ps(BULLET_LIMIT_X);
+  const __m256 limitY = _mm256_set1_ps(BULLET_LIMIT_Y);
+  const __m256 limitMin = _mm256_set1_ps(BULLET_LIMIT_MIN);
+  int i = begin;
+
+  // NOTE: Explicit mul and add, not FMA, to round like the scalar kernel
+  for (; i + 8 <= end; i += 8) {
+    __m256 x =
+        _mm256_add_ps(_mm256_loadu_ps(bullets->posX + i),
+                      _mm256_mul_ps(_mm256_loadu_ps(bullets->velX + i), vdt));
+    __m256 y =
+        _mm256_add_ps(_mm256_loadu_ps(bullets->posY + i),
+                      _mm256_mul_ps(_mm256_loadu_ps(bullets->velY + i), vdt));
+    _mm256_storeu_ps(bullets->posX + i, x);
+    _mm256_storeu_ps(bullets->posY + i, y);
+
+    x = _mm256_add_ps(x, offsetX);
+    y = _mm256_add_ps(y, offsetY);
+    __m256 out =
+        _mm256_or_ps(_mm256_or_ps(_mm256_cmp_ps(x, limitX, _CMP_GE_OQ),
+                                  _mm256_cmp_ps(x, limitMin, _CMP_LE_OQ)),
+                     _mm256_or_ps(_mm256_cmp_ps(y, limitY, _CMP_GE_OQ),
+                                  _mm256_cmp_ps(y, limitMin, _CMP_LE_OQ)));
+    int mask = _mm256_movemask_ps(out);
+    if (mask != 0)
+      FlagDead(bullets, i, mask);
+  }
+
+  return i;
+}
+
+static int IntegrateRocksAVX2(EntityStore *rocks, float dt, int begin,
+                              int end) {
+  const __m256 vdt = _mm256_set1_ps(dt);
+  const __m256 zero = _mm256_setzero_ps();
+  int i = begin;
+
+  for (; i + 8 <= end; i += 8) {
+    __m256 x =
+        _mm256_add_ps(_mm256_loadu_ps(rocks->posX + i),
+                      _mm256_mul_ps(_mm256_loadu_ps(rocks->velX + i), vdt));
+    __m256 y =
+        _mm256_add_ps(_mm256_loadu_ps(rocks->posY + i),
+                      _mm256_mul_ps(_mm256_loadu_ps(rocks->velY + i), vdt));
+    __m256 life = _mm256_sub_ps(_mm256_loadu_ps(rocks->lifeTime + i), vdt);
+    _mm256_storeu_ps(rocks->posX + i, x);
+    _mm256_storeu_ps(rocks->posY + i, y);
+    _mm256_storeu_ps(rocks->lifeTime + i, life);
+
+    int mask = _mm256_movemask_ps(_mm256_cmp_ps(life, zero, _CMP_LT_OQ));
+    if (mask != 0)
+      FlagDead(rocks, i, mask);
+  }
+
+  return i;
+}
+#endif
@@ -0,0 +1,53 @@
+/**********************************************************************************************
+ *
+ *   Entity Kernels - Vectorized position integration and expiry tests
+ *
+ *   The per-frame bullet and rock updates reduce to pos += vel * dt plus a
+ *   bounds or lifetime test, run over the packed EntityStore arrays. Each
+ *   kernel flags leaving entities with ENTITY_FLAG_DEAD and leaves removal to
+ *   the caller.
+ *
+ *   Which SIMD kernels exist is decided at build time: SSE2 is part of every
+ *   x86-64 target, AVX2 needs -mavx2 (USE_AVX2=TRUE in the Makefile). The
+ *   widest compiled kernel is used unless SetEntityKernel() picks another.
+ *   All kernels do the same IEEE operations in the same order, so they
+ *   produce bit-identical stores.
+ *
+ **********************************************************************************************/
+
+#ifndef ENTITY_KERNELS_H
+#define ENTITY_KERNELS_H
+
+#include "entity_store.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum EntityKernel {
+  ENTITY_KERNEL_SCALAR = 0,
+  ENTITY_KERNEL_SSE2,
+  ENTITY_KERNEL_AVX2,
+} EntityKernel;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//----------------------------------------------------------------------------------
+// Entity Kernels Functions Declaration
+//----------------------------------------------------------------------------------
+EntityKernel GetBestEntityKernel(void); // Widest kernel in this build
+EntityKernel GetEntityKernel(void);
+void SetEntityKernel(EntityKernel kernel); // Clamped to the best kernel
+const char *GetEntityKernelName(EntityKernel kernel);
+
+// Integrate [begin, end) and flag bullets that left the play field
+void IntegrateBulletRange(EntityStore *bullets, float dt, int begin, int end);
+// Integrate [begin, end), age and flag rocks whose lifetime ran out
+void IntegrateRockRange(EntityStore *rocks, float dt, int begin, int end);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ENTITY_KERNELS_H
@@ -0,0 +1,129 @@
+/**********************************************************************************************
+ *
+ *   Entity Store - Struct-of-arrays storage for gameplay entities
+ *
+ *   See entity_store.h for the spawn/despawn rules.
+ *
+ **********************************************************************************************/
+
+#include "entity_store.h"
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static int allocCount = 0;
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static void ResizeEntityStore(EntityStore *store, int capacity);
+
+//----------------------------------------------------------------------------------
+// Entity Store Functions Definition
+//----------------------------------------------------------------------------------
+
+void InitEntityStore(EntityStore *store, int capacity, MemTag tag) {
+  *store = (EntityStore){.tag = tag};
+  ResizeEntityStore(store, (capacity > ENTITY_STORE_MIN_CAPACITY)
+                               ? capacity
+                               : ENTITY_STORE_MIN_CAPACITY);
+}
+
+void UnloadEntityStore(EntityStore *store) {
+  TaggedFree(store->posX);
+  TaggedFree(store->posY);
+  TaggedFree(store->velX);
+  TaggedFree(store->velY);
+  TaggedFree(store->lifeTime);
+  TaggedFree(store->flags);
+  TaggedFree(store->prevPosX);
+  TaggedFree(store->prevPosY);
+  TaggedFree(store->dir);
+  TaggedFree(store->radius);
+  TaggedFree(store->model);
+  *store = (EntityStore){0};
+}
+
+void ReserveEntityStore(EntityStore *store, int capacity) {
+  if (capacity > store->capacity)
+    ResizeEntityStore(store, capacity);
+}
+
+int SpawnEntity(EntityStore *store) {
+  if (store->count == store->capacity)
+    ResizeEntityStore(store, store->capacity * 2);
+
+  int index = store->count;
+  store->posX[index] = 0.0f;
+  store->posY[index] = 0.0f;
+  store->velX[index] = 0.0f;
+  store->velY[index] = 0.0f;
+  store->lifeTime[index] = 0.0f;
+  store->flags[index] = 0;
+  store->prevPosX[index] = 0.0f;
+  store->prevPosY[index] = 0.0f;
+  store->dir[index] = 0.0f;
+  store->radius[index] = 0.0f;
+  store->model[index] = MODEL_HANDLE_INVALID;
+  store->count++;
+
+  return index;
+}
+
+void RemoveEntity(EntityStore *store, int index) {
+  int last = store->count - 1;
+
+  if (index != last) {
+    store->posX[index] = store->posX[last];
+    store->posY[index] = store->posY[last];
+    store->velX[index] = store->velX[last];
+    store->velY[index] = store->velY[last];
+    store->lifeTime[index] = store->lifeTime[last];
+    store->flags[index] = store->flags[last];
+    store->prevPosX[index] = store->prevPosX[last];
+    store->prevPosY[index] = store->prevPosY[last];
+    store->dir[index] = store->dir[last];
+    store->radius[index] = store->radius[last];
+    store->model[index] = store->model[last];
+  }
+  store->count--;
+}
+
+void DespawnEntity(EntityStore *store, int index) {
+  store->flags[index] |= ENTITY_FLAG_DEAD;
+}
+
+void CompactEntityStore(EntityStore *store) {
+  // Walk backwards so the entity swapped into slot i has already been checked
+  for (int i = store->count - 1; i >= 0; i--) {
+    if (store->flags[i] & ENTITY_FLAG_DEAD)
+      RemoveEntity(store, i);
+  }
+}
+
+int GetEntityStoreAllocCount(void) { return allocCount; }
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+static void ResizeEntityStore(EntityStore *store, int capacity) {
+  MemTag tag = store->tag;
+  size_t floats = sizeof(float) * capacity;
+  store->posX = TaggedRealloc(tag, store->posX, floats);
+  store->posY = TaggedRealloc(tag, store->posY, floats);
+  store->velX = TaggedRealloc(tag, store->velX, floats);
+  store->velY = TaggedRealloc(tag, store->velY, floats);
+  store->lifeTime = TaggedRealloc(tag, store->lifeTime, floats);
+  store->flags =
+      TaggedRealloc(tag, store->flags, sizeof(unsigned char) * capacity);
+  store->prevPosX = TaggedRealloc(tag, store->prevPosX, floats);
+  store->prevPosY = TaggedRealloc(tag, store->prevPosY, floats);
+  store->dir = TaggedRealloc(tag, store->dir, floats);
+  store->radius = TaggedRealloc(tag, store->radius, floats);
+  store->model =
+      TaggedRealloc(tag, store->model, sizeof(ModelHandle) * capacity);
+  store->capacity = capacity;
+  allocCount++;
+}
@@ -0,0 +1,81 @@
+/**********************************************************************************************
+ *
+ *   Entity Store - Struct-of-arrays storage for gameplay entities
+ *
+ *   Every per-entity field lives in its own array so the integration loops
+ *   only touch the fields they read. Entities are addressed by index in
+ *   [0, count) and iterated with a plain for loop.
+ *
+ *   Storage grows geometrically and is never shrunk, so once a store has
+ *   reached its working size spawning and despawning touch no heap memory.
+ *   ReserveEntityStore() sizes a store for a known worst case up front, which
+ *   turns it into a fixed pool that never grows mid-game.
+ *   RemoveEntity() swaps the last entity into the freed slot. DespawnEntity()
+ *   only flags an entity so it can be called while iterating;
+ *   CompactEntityStore() then swap-removes every flagged entity. Neither keeps
+ *   spawn order.
+ *
+ **********************************************************************************************/
+
+#ifndef ENTITY_STORE_H
+#define ENTITY_STORE_H
+
+#include "model_cache.h"
+#include "tagged_heap.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define ENTITY_STORE_MIN_CAPACITY 64
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum EntityFlags {
+  ENTITY_FLAG_HIT = 1 << 0,    // Hit by a bullet, broken up this tick
+  ENTITY_FLAG_DEAD = 1 << 1,   // Pending removal by CompactEntityStore()
+  ENTITY_FLAG_DEBRIS = 1 << 2, // Split off a bigger rock
+} EntityFlags;
+
+typedef struct EntityStore {
+  // Hot fields, read every update
+  float *posX;
+  float *posY;
+  float *velX; // Units per second, fixed at spawn
+  float *velY;
+  float *lifeTime;
+  unsigned char *flags;
+
+  // Cold fields, read by collisions and drawing
+  float *prevPosX; // Position before the last simulation tick, for
+  float *prevPosY; // interpolated drawing
+  float *dir;      // Facing, only used for drawing once velocity is set
+  float *radius;
+  ModelHandle *model;
+
+  int count;
+  int capacity;
+  MemTag tag; // Heap tag of the arrays
+} EntityStore;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//----------------------------------------------------------------------------------
+// Entity Store Functions Declaration
+//----------------------------------------------------------------------------------
+void InitEntityStore(EntityStore *store, int capacity, MemTag tag);
+void UnloadEntityStore(EntityStore *store);
+void ReserveEntityStore(EntityStore *store, int capacity); // Never shrinks
+int SpawnEntity(EntityStore *store); // Returns the index of a zeroed entity
+void RemoveEntity(EntityStore *store, int index); // Swap-and-pop, O(1)
+void DespawnEntity(EntityStore *store, int index); // Deferred removal
+void CompactEntityStore(EntityStore *store);
+int GetEntityStoreAllocCount(void); // Storage (re)allocations, all stores
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ENTITY_STORE_H
@@ -0,0 +1,125 @@
+/**********************************************************************************************
+ *
+ *   Frame Arena - Bump allocator for scratch data that lives one frame
+ *
+ *   See frame_arena.h for the lifetime rules and the heap guard.
+ *
+ **********************************************************************************************/
+
+#include "frame_arena.h"
+#include "raylib.h"
+#include "tagged_heap.h"
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define HEAP_GUARD_LOG_LIMIT 16 // Reports logged before going quiet
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static unsigned char *arenaBase = NULL;
+static size_t arenaCapacity = 0;
+static size_t arenaUsed = 0;
+static size_t arenaHighWater = 0;
+static int arenaOverflows = 0;
+
+static bool heapGuard = false;
+static bool heapAssert = false;
+static int guardedHeapAllocs = 0;
+
+//----------------------------------------------------------------------------------
+// Frame Arena Functions Definition
+//----------------------------------------------------------------------------------
+
+void InitFrameArena(size_t capacity) {
+  UnloadFrameArena();
+
+  // The block itself is the one heap allocation this module makes
+  arenaBase = TaggedAlloc(MEM_TAG_ARENA, capacity);
+  arenaCapacity = (arenaBase != NULL) ? capacity : 0;
+  TraceLog(LOG_INFO, "ARENA: Frame arena of %d KB",
+           (int)(arenaCapacity / 1024));
+}
+
+void UnloadFrameArena(void) {
+  TaggedFree(arenaBase);
+  arenaBase = NULL;
+  arenaCapacity = 0;
+  arenaUsed = 0;
+}
+
+void ResetFrameArena(void) { arenaUsed = 0; }
+
+void *FrameAlloc(size_t size) {
+  if (arenaBase == NULL)
+    InitFrameArena(FRAME_ARENA_DEFAULT_SIZE);
+
+  // The base comes from the heap, aligned at least as strictly as this
+  size_t offset = (arenaUsed + FRAME_ARENA_ALIGNMENT - 1) &
+                  ~(size_t)(FRAME_ARENA_ALIGNMENT - 1);
+  if ((offset > arenaCapacity) || (size > arenaCapacity - offset)) {
+    if (arenaOverflows++ == 0)
+      TraceLog(LOG_WARNING,
+               "ARENA: Out of frame memory (%d of %d KB used, %d B asked)",
+               (int)(arenaUsed / 1024), (int)(arenaCapacity / 1024),
+               (int)size);
+    return NULL;
+  }
+
+  arenaUsed = offset + size;
+  if (arenaUsed > arenaHighWater)
+    arenaHighWater = arenaUsed;
+
+  return arenaBase + offset;
+}
+
+void *FrameAllocZeroed(size_t size) {
+  void *data = FrameAlloc(size);
+  if (data != NULL)
+    memset(data, 0, size);
+
+  return data;
+}
+
+size_t GetFrameArenaMark(void) { return arenaUsed; }
+
+void RewindFrameArena(size_t mark) {
+  if (mark < arenaUsed)
+    arenaUsed = mark;
+}
+
+FrameArenaStats GetFrameArenaStats(void) {
+  FrameArenaStats stats = {
+      .capacity = arenaCapacity,
+      .used = arenaUsed,
+      .highWater = arenaHighWater,
+      .overflows = arenaOverflows,
+      .guardedHeapAllocs = guardedHeapAllocs,
+  };
+
+  return stats;
+}
+
+void SetFrameHeapGuard(bool steady) { heapGuard = steady; }
+
+void SetFrameHeapAssert(bool enabled) { heapAssert = enabled; }
+
+void NoteHeapAllocation(const char *site, size_t size) {
+  if (!heapGuard)
+    return;
+
+  guardedHeapAllocs++;
+  if (heapAssert)
+    TraceLog(LOG_FATAL, "ARENA: Heap allocation in a steady-state frame: "
+                        "%s, %d bytes",
+             site, (int)size);
+  else if (guardedHeapAllocs <= HEAP_GUARD_LOG_LIMIT)
+    TraceLog(LOG_WARNING,
+             "ARENA: Heap allocation in a steady-state frame: %s, %d bytes%s",
+             site, (int)size,
+             (guardedHeapAllocs == HEAP_GUARD_LOG_LIMIT)
+                 ? " (further reports not logged)"
+                 : "");
+}
@@ -0,0 +1,75 @@
+/**********************************************************************************************
+ *
+ *   Frame Arena - Bump allocator for scratch data that lives one frame
+ *
+ *   FrameAlloc() hands out aligned slices of one block allocated up front;
+ *   ResetFrameArena(), called at the top of every frame, takes them all
+ *   back at once. Nothing is freed individually and nothing touches the
+ *   heap after the block exists, so any screen can use it for transient
+ *   arrays at no cost. Code that needs scratch space for a shorter scope can
+ *   rewind to a GetFrameArenaMark(). A full arena returns NULL and counts an
+ *   overflow rather than growing; the high-water mark tells how big it needs
+ *   to be.
+ *
+ *   Heap guard: every TaggedAlloc() and TaggedRealloc() reports itself
+ *   through NoteHeapAllocation(), and so does code that allocates through
+ *   raylib instead. While a screen declares its frames steady-state with
+ *   SetFrameHeapGuard(), every such report is counted and logged, and with
+ *   SetFrameHeapAssert() it is a fatal error, so a regression that allocates
+ *   in the gameplay loop cannot go unnoticed.
+ *
+ *   Main thread only.
+ *
+ **********************************************************************************************/
+
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define FRAME_ARENA_DEFAULT_SIZE (4 * 1024 * 1024) // Used by lazy init
+#define FRAME_ARENA_ALIGNMENT 16
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct FrameArenaStats {
+  size_t capacity;
+  size_t used;      // This frame so far
+  size_t highWater; // Most used in any frame
+  int overflows;    // Allocations refused, since init
+  // Heap allocations reported in steady-state frames, since init
+  int guardedHeapAllocs;
+} FrameArenaStats;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//----------------------------------------------------------------------------------
+// Frame Arena Functions Declaration
+//----------------------------------------------------------------------------------
+void InitFrameArena(size_t capacity); // Optional, first use inits by default
+void UnloadFrameArena(void);
+void ResetFrameArena(void); // Top of the frame, frees every allocation
+
+void *FrameAlloc(size_t size); // Uninitialized, NULL when the arena is full
+void *FrameAllocZeroed(size_t size);
+size_t GetFrameArenaMark(void);
+void RewindFrameArena(size_t mark); // Frees everything since the mark
+
+FrameArenaStats GetFrameArenaStats(void);
+
+void SetFrameHeapGuard(bool steady); // Current and later frames
+void SetFrameHeapAssert(bool enabled);
+void NoteHeapAllocation(const char *site, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FRAME_ARENA_H
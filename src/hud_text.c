@@ -0,0 +1,193 @@
+/**********************************************************************************************
+ *
+ *   HUD Text - Single-line text widgets with cached glyph layout
+ *
+ *   See hud_text.h for when a layout is redone.
+ *
+ **********************************************************************************************/
+
+#include "hud_text.h"
+#include "raylib.h"
+#include "rlgl.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define DEFAULT_FONT_SIZE 10 // What DrawText() scales spacing against
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static const HudText *queue[HUD_TEXT_MAX_QUEUED] = {0};
+static int queueCount = 0;
+static bool cachingEnabled = true;
+static HudTextStats stats = {0};
+static int rebuilds = 0; // Since the last flush
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static void LayoutHudText(HudText *widget);
+static void DrawCachedGlyphs(const HudText *widget);
+
+//----------------------------------------------------------------------------------
+// HUD Text Functions Definition
+//----------------------------------------------------------------------------------
+
+void InitHudText(HudText *widget, Font font, Vector2 position, float fontSize,
+                 float spacing, Color color) {
+  *widget = (HudText){
+      .font = font,
+      .position = position,
+      .fontSize = fontSize,
+      .spacing = spacing,
+      .color = color,
+  };
+}
+
+void InitHudTextDefault(HudText *widget, int posX, int posY, int fontSize,
+                        Color color) {
+  if (fontSize < DEFAULT_FONT_SIZE)
+    fontSize = DEFAULT_FONT_SIZE;
+
+  // Integer division, as in DrawText(): size 15 is spaced 1, not 1.5
+  InitHudText(widget, GetFontDefault(), (Vector2){(float)posX, (float)posY},
+              (float)fontSize, (float)(fontSize / DEFAULT_FONT_SIZE), color);
+}
+
+void SetHudText(HudText *widget, const char *text) {
+  if (strncmp(widget->text, text, HUD_TEXT_MAX_LENGTH - 1) == 0)
+    return;
+
+  strncpy(widget->text, text, HUD_TEXT_MAX_LENGTH - 1);
+  widget->text[HUD_TEXT_MAX_LENGTH - 1] = '\0';
+  LayoutHudText(widget);
+}
+
+void SetHudTextFormat(HudText *widget, const char *text, ...) {
+  char buffer[HUD_TEXT_MAX_LENGTH] = {0};
+  va_list args;
+  va_start(args, text);
+  vsnprintf(buffer, HUD_TEXT_MAX_LENGTH, text, args);
+  va_end(args);
+
+  SetHudText(widget, buffer);
+}
+
+void BeginHudTextBatch(void) { queueCount = 0; }
+
+void PushHudText(const HudText *widget) {
+  if (queueCount == HUD_TEXT_MAX_QUEUED) {
+    TraceLog(LOG_WARNING, "HUDTEXT: Batch full, widget dropped");
+    return;
+  }
+
+  queue[queueCount++] = widget;
+}
+
+void FlushHudTextBatch(void) {
+  stats = (HudTextStats){.widgets = queueCount, .rebuilds = rebuilds};
+  rebuilds = 0;
+
+  for (int i = 0; i < queueCount; i++) {
+    const HudText *widget = queue[i];
+    if (cachingEnabled) {
+      DrawCachedGlyphs(widget);
+    } else {
+      DrawTextEx(widget->font, widget->text, widget->position,
+                 widget->fontSize, widget->spacing, widget->color);
+    }
+    stats.glyphs += widget->glyphCount;
+  }
+  rlSetTexture(0);
+
+  queueCount = 0;
+}
+
+void SetHudTextCaching(bool enabled) { cachingEnabled = enabled; }
+
+bool IsHudTextCaching(void) { return cachingEnabled; }
+
+HudTextStats GetHudTextStats(void) { return stats; }
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+// Same placement as DrawTextEx()/DrawTextCodepoint(), minus the position
+static void LayoutHudText(HudText *widget) {
+  const Font *font = &widget->font;
+  widget->glyphCount = 0;
+  rebuilds++;
+  if ((font->texture.id == 0) || (font->baseSize == 0))
+    return;
+
+  float scale = widget->fontSize / font->baseSize;
+  float padding = (float)font->glyphPadding;
+  float atlasWidth = (float)font->texture.width;
+  float atlasHeight = (float)font->texture.height;
+  float penX = 0.0f;
+
+  for (int i = 0; widget->text[i] != '\0';) {
+    int codepointSize = 0;
+    int codepoint = GetCodepointNext(&widget->text[i], &codepointSize);
+    i += (codepointSize > 0) ? codepointSize : 1;
+
+    int index = GetGlyphIndex(*font, codepoint);
+    Rectangle rec = font->recs[index];
+    if ((codepoint != ' ') && (codepoint != '\t')) {
+      HudTextGlyph *glyph = &widget->glyphs[widget->glyphCount++];
+      glyph->dest = (Rectangle){
+          penX + (font->glyphs[index].offsetX - padding) * scale,
+          (font->glyphs[index].offsetY - padding) * scale,
+          (rec.width + 2.0f * padding) * scale,
+          (rec.height + 2.0f * padding) * scale,
+      };
+      glyph->uvMin = (Vector2){(rec.x - padding) / atlasWidth,
+                               (rec.y - padding) / atlasHeight};
+      glyph->uvMax = (Vector2){(rec.x + rec.width + padding) / atlasWidth,
+                               (rec.y + rec.height + padding) / atlasHeight};
+    }
+
+    float advance = (font->glyphs[index].advanceX != 0)
+                        ? (float)font->glyphs[index].advanceX
+                        : rec.width;
+    penX += advance * scale + widget->spacing;
+  }
+}
+
+// Consecutive widgets on the same atlas stay in one rlgl draw call
+static void DrawCachedGlyphs(const HudText *widget) {
+  if ((widget->glyphCount == 0) || (widget->font.texture.id == 0))
+    return;
+
+  float x = widget->position.x;
+  float y = widget->position.y;
+  Color color = widget->color;
+
+  rlCheckRenderBatchLimit(4 * widget->glyphCount);
+  rlSetTexture(widget->font.texture.id);
+  rlBegin(RL_QUADS);
+  rlColor4ub(color.r, color.g, color.b, color.a);
+  rlNormal3f(0.0f, 0.0f, 1.0f);
+  for (int i = 0; i < widget->glyphCount; i++) {
+    const HudTextGlyph *glyph = &widget->glyphs[i];
+    float left = x + glyph->dest.x;
+    float top = y + glyph->dest.y;
+    float right = left + glyph->dest.width;
+    float bottom = top + glyph->dest.height;
+
+    rlTexCoord2f(glyph->uvMin.x, glyph->uvMin.y);
+    rlVertex2f(left, top);
+    rlTexCoord2f(glyph->uvMin.x, glyph->uvMax.y);
+    rlVertex2f(left, bottom);
+    rlTexCoord2f(glyph->uvMax.x, glyph->uvMax.y);
+    rlVertex2f(right, bottom);
+    rlTexCoord2f(glyph->uvMax.x, glyph->uvMin.y);
+    rlVertex2f(right, top);
+  }
+  rlEnd();
+}
@@ -0,0 +1,86 @@
+/**********************************************************************************************
+ *
+ *   HUD Text - Single-line text widgets with cached glyph layout
+ *
+ *   A HudText keeps the string it shows and the textured quad of every glyph,
+ *   laid out the way DrawTextEx() would lay them out. SetHudText() and
+ *   SetHudTextFormat() compare the new string with the cached one and only
+ *   redo the layout when it changed, so a label whose value holds still
+ *   costs one string compare per frame.
+ *
+ *   Widgets are drawn in batches: PushHudText() queues a widget and
+ *   FlushHudTextBatch() writes the cached quads of every queued widget into
+ *   the rlgl render batch in one go, so text sharing a font goes out in one
+ *   draw call. Widgets must stay alive until the flush.
+ *
+ *   With caching turned off the flush falls back to DrawTextEx() per widget,
+ *   which lays the text out again every frame, for comparing both in the
+ *   profiler overlay.
+ *
+ **********************************************************************************************/
+
+#ifndef HUD_TEXT_H
+#define HUD_TEXT_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define HUD_TEXT_MAX_LENGTH 96 // Bytes, longer text is cut
+#define HUD_TEXT_MAX_QUEUED 64 // Widgets per batch
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct HudTextGlyph {
+  Rectangle dest;       // Relative to the widget position, in pixels
+  Vector2 uvMin, uvMax; // Font atlas texture coordinates
+} HudTextGlyph;
+
+typedef struct HudText {
+  Font font;
+  Vector2 position;
+  float fontSize;
+  float spacing;
+  Color color;
+
+  char text[HUD_TEXT_MAX_LENGTH];
+  HudTextGlyph glyphs[HUD_TEXT_MAX_LENGTH];
+  int glyphCount; // Spaces take no quad
+} HudText;
+
+typedef struct HudTextStats {
+  int widgets;  // Flushed by the last batch
+  int glyphs;   // Quads written by the last batch
+  int rebuilds; // Layouts redone since the previous flush
+} HudTextStats;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//----------------------------------------------------------------------------------
+// HUD Text Functions Declaration
+//----------------------------------------------------------------------------------
+void InitHudText(HudText *widget, Font font, Vector2 position, float fontSize,
+                 float spacing, Color color);
+// Default font, sized and spaced like DrawText()
+void InitHudTextDefault(HudText *widget, int posX, int posY, int fontSize,
+                        Color color);
+void SetHudText(HudText *widget, const char *text);
+void SetHudTextFormat(HudText *widget, const char *text, ...);
+
+void BeginHudTextBatch(void);
+void PushHudText(const HudText *widget);
+void FlushHudTextBatch(void);
+
+void SetHudTextCaching(bool enabled);
+bool IsHudTextCaching(void);
+HudTextStats GetHudTextStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HUD_TEXT_H
@@ -0,0 +1,188 @@
+/**********************************************************************************************
+ *
+ *   Instance Renderer - Batched drawing of cached models
+ *
+ *   See instance_renderer.h for the batching rules.
+ *
+ **********************************************************************************************/
+
+#include "instance_renderer.h"
+#include "asset_pack.h"
+#include "raylib.h"
+#include "resource_tracker.h"
+#include "rlgl.h"
+#include "tagged_heap.h"
+#include <stddef.h>
+
+#if defined(PLATFORM_DESKTOP)
+#define GLSL_VERSION 330
+#else // PLATFORM_ANDROID, PLATFORM_WEB
+#define GLSL_VERSION 100
+#endif
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct InstanceBucket {
+  ModelHandle model; // MODEL_HANDLE_INVALID when the bucket is free
+  Color color;
+  bool wires;
+  Matrix *transforms;
+  int count;
+  int capacity;
+} InstanceBucket;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static InstanceBucket buckets[MAX_INSTANCE_BUCKETS] = {0};
+static int numBuckets = 0;
+static Material instancedMaterial = {0};
+static Material fallbackMaterial = {0};
+static bool instancingReady = false;
+static bool instancingEnabled = true;
+static InstanceRendererStats stats = {0};
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static InstanceBucket *FindBucket(ModelHandle model, Color color, bool wires);
+
+//----------------------------------------------------------------------------------
+// Instance Renderer Functions Definition
+//----------------------------------------------------------------------------------
+
+void InitInstanceRenderer(void) {
+  Shader shader = LoadPackedShader(
+      TextFormat("resources/shaders/glsl%i/instancing.vs", GLSL_VERSION),
+      TextFormat("resources/shaders/glsl%i/instancing.fs", GLSL_VERSION));
+  instancingReady = IsShaderReady(shader);
+
+  if (instancingReady) {
+    shader.locs[SHADER_LOC_MATRIX_MVP] = GetShaderLocation(shader, "mvp");
+    shader.locs[SHADER_LOC_MATRIX_MODEL] =
+        GetShaderLocationAttrib(shader, "instanceTransform");
+    instancedMaterial = LoadMaterialDefault();
+    instancedMaterial.shader = TrackShader(shader, "instancing");
+  } else {
+    TraceLog(LOG_WARNING, "INSTANCING: Shader not available, using fallback");
+  }
+
+  fallbackMaterial = LoadMaterialDefault();
+  numBuckets = 0;
+}
+
+void UnloadInstanceRenderer(void) {
+  for (int i = 0; i < numBuckets; i++)
+    TaggedFree(buckets[i].transforms);
+  numBuckets = 0;
+
+  if (instancingReady) {
+    UntrackResource(RESOURCE_SHADER, instancedMaterial.shader.id);
+    UnloadMaterial(instancedMaterial); // NOTE: Also unloads the shader
+  }
+  UnloadMaterial(fallbackMaterial);
+  instancingReady = false;
+}
+
+void BeginInstanceBatch(void) {
+  // Buckets left empty by the previous frame are released for reuse, the
+  // transform storage stays allocated
+  for (int i = 0; i < numBuckets; i++) {
+    if (buckets[i].count == 0)
+      buckets[i].model = MODEL_HANDLE_INVALID;
+    buckets[i].count = 0;
+  }
+}
+
+void PushInstance(ModelHandle model, Matrix transform, Color color,
+                  bool wires) {
+  InstanceBucket *bucket = FindBucket(model, color, wires);
+  if (bucket == NULL)
+    return;
+
+  if (bucket->count == bucket->capacity) {
+    int capacity = (bucket->capacity > 0) ? bucket->capacity * 2 : 64;
+    bucket->transforms = TaggedRealloc(MEM_TAG_RENDERER, bucket->transforms,
+                                       sizeof(Matrix) * capacity);
+    bucket->capacity = capacity;
+  }
+  bucket->transforms[bucket->count] = transform;
+  bucket->count++;
+}
+
+void FlushInstanceBatch(void) {
+  bool instanced = instancingEnabled && instancingReady;
+  stats = (InstanceRendererStats){.instanced = instanced};
+
+  for (int i = 0; i < numBuckets; i++) {
+    InstanceBucket *bucket = &buckets[i];
+    if (bucket->count == 0)
+      continue;
+
+    Model model = GetCachedModel(bucket->model);
+    if (bucket->wires)
+      rlEnableWireMode();
+
+    for (int m = 0; m < model.meshCount; m++) {
+      if (instanced) {
+        instancedMaterial.maps[MATERIAL_MAP_DIFFUSE].color = bucket->color;
+        DrawMeshInstanced(model.meshes[m], instancedMaterial,
+                          bucket->transforms, bucket->count);
+        stats.drawCalls++;
+      } else {
+        fallbackMaterial.maps[MATERIAL_MAP_DIFFUSE].color = bucket->color;
+        for (int j = 0; j < bucket->count; j++)
+          DrawMesh(model.meshes[m], fallbackMaterial, bucket->transforms[j]);
+        stats.drawCalls += bucket->count;
+      }
+    }
+
+    if (bucket->wires)
+      rlDisableWireMode();
+    stats.instances += bucket->count;
+  }
+}
+
+void SetInstancingEnabled(bool enabled) { instancingEnabled = enabled; }
+
+bool IsInstancingEnabled(void) { return instancingEnabled && instancingReady; }
+
+InstanceRendererStats GetInstanceRendererStats(void) { return stats; }
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+static InstanceBucket *FindBucket(ModelHandle model, Color color, bool wires) {
+  InstanceBucket *freeBucket = NULL;
+
+  for (int i = 0; i < numBuckets; i++) {
+    InstanceBucket *bucket = &buckets[i];
+    if (bucket->model == MODEL_HANDLE_INVALID) {
+      if (freeBucket == NULL)
+        freeBucket = bucket;
+      continue;
+    }
+    if ((bucket->model == model) && (bucket->wires == wires) &&
+        (bucket->color.r == color.r) && (bucket->color.g == color.g) &&
+        (bucket->color.b == color.b) && (bucket->color.a == color.a))
+      return bucket;
+  }
+
+  if ((freeBucket == NULL) && (numBuckets < MAX_INSTANCE_BUCKETS)) {
+    freeBucket = &buckets[numBuckets];
+    *freeBucket = (InstanceBucket){0};
+    numBuckets++;
+  }
+
+  if (freeBucket == NULL) {
+    TraceLog(LOG_WARNING, "INSTANCING: Out of buckets, instance dropped");
+    return NULL;
+  }
+
+  freeBucket->model = model;
+  freeBucket->color = color;
+  freeBucket->wires = wires;
+  return freeBucket;
+}
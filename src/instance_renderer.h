@@ -0,0 +1,53 @@
+/**********************************************************************************************
+ *
+ *   Instance Renderer - Batched drawing of cached models
+ *
+ *   Entities push one transform per frame into a bucket keyed by model, color
+ *   and fill mode. FlushInstanceBatch() then submits each bucket with a single
+ *   DrawMeshInstanced() call, or falls back to one DrawMesh() per instance when
+ *   instancing is disabled or the instancing shader failed to load.
+ *
+ **********************************************************************************************/
+
+#ifndef INSTANCE_RENDERER_H
+#define INSTANCE_RENDERER_H
+
+#include "model_cache.h"
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define MAX_INSTANCE_BUCKETS 64
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct InstanceRendererStats {
+  int drawCalls; // Draw calls issued by the last flush
+  int instances; // Instances submitted by the last flush
+  bool instanced; // Whether the last flush used the instanced path
+} InstanceRendererStats;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//----------------------------------------------------------------------------------
+// Instance Renderer Functions Declaration
+//----------------------------------------------------------------------------------
+void InitInstanceRenderer(void);
+void UnloadInstanceRenderer(void);
+void BeginInstanceBatch(void);
+void PushInstance(ModelHandle model, Matrix transform, Color color,
+                  bool wires);
+void FlushInstanceBatch(void); // Call inside BeginMode3D()/EndMode3D()
+void SetInstancingEnabled(bool enabled);
+bool IsInstancingEnabled(void);
+InstanceRendererStats GetInstanceRendererStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // INSTANCE_RENDERER_H
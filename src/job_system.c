@@ -0,0 +1,174 @@
+/**********************************************************************************************
+ *
+ *   Job System - Small worker-thread pool for data-parallel loops
+ *
+ *   See job_system.h for the threading contract.
+ *
+ **********************************************************************************************/
+
+#include "job_system.h"
+#include "raylib.h"
+
+#if !defined(PLATFORM_WEB)
+#include <pthread.h>
+#define JOB_SYSTEM_THREADED
+#endif
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct JobChunk {
+  int begin;
+  int end;
+} JobChunk;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static int activeThreads = 1; // Workers plus the calling thread
+
+#if defined(JOB_SYSTEM_THREADED)
+static pthread_t workers[MAX_JOB_THREADS - 1];
+static pthread_mutex_t queueMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t workReady = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t workDone = PTHREAD_COND_INITIALIZER;
+static bool quitWorkers = false;
+
+// Job queue of the RunParallelFor() call in flight, guarded by queueMutex
+static JobChunk chunks[MAX_JOB_CHUNKS];
+static int chunkCount = 0;
+static int nextChunk = 0;
+static int chunksDone = 0;
+static JobFunc jobFunc = NULL;
+static void *jobData = NULL;
+#endif
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+#if defined(JOB_SYSTEM_THREADED)
+static void *WorkerMain(void *arg);
+static void RunQueuedChunks(void);
+#endif
+
+//----------------------------------------------------------------------------------
+// Job System Functions Definition
+//----------------------------------------------------------------------------------
+
+void InitJobSystem(int threadCount) {
+  if (activeThreads > 1)
+    UnloadJobSystem();
+
+  if (threadCount < 1)
+    threadCount = 1;
+  if (threadCount > MAX_JOB_THREADS)
+    threadCount = MAX_JOB_THREADS;
+
+#if defined(JOB_SYSTEM_THREADED)
+  quitWorkers = false;
+  activeThreads = 1;
+  for (int i = 0; i < threadCount - 1; i++) {
+    if (pthread_create(&workers[i], NULL, WorkerMain, NULL) != 0) {
+      TraceLog(LOG_WARNING, "JOBS: Failed to start worker %d", i + 1);
+      break;
+    }
+    activeThreads++;
+  }
+#endif
+
+  TraceLog(LOG_INFO, "JOBS: Running on %d thread(s)", activeThreads);
+}
+
+void UnloadJobSystem(void) {
+#if defined(JOB_SYSTEM_THREADED)
+  pthread_mutex_lock(&queueMutex);
+  quitWorkers = true;
+  pthread_cond_broadcast(&workReady);
+  pthread_mutex_unlock(&queueMutex);
+
+  for (int i = 0; i < activeThreads - 1; i++)
+    pthread_join(workers[i], NULL);
+#endif
+
+  activeThreads = 1;
+}
+
+int GetJobThreadCount(void) { return activeThreads; }
+
+void RunParallelFor(int count, int minChunkSize, JobFunc func, void *data) {
+  if (count <= 0)
+    return;
+  if (minChunkSize < 1)
+    minChunkSize = 1;
+
+  int numChunks = activeThreads * JOB_CHUNKS_PER_THREAD;
+  if (numChunks > MAX_JOB_CHUNKS)
+    numChunks = MAX_JOB_CHUNKS;
+  if (numChunks > count / minChunkSize)
+    numChunks = count / minChunkSize;
+
+  if ((activeThreads <= 1) || (numChunks <= 1)) {
+    func(data, 0, count);
+    return;
+  }
+
+#if defined(JOB_SYSTEM_THREADED)
+  pthread_mutex_lock(&queueMutex);
+  for (int i = 0; i < numChunks; i++) {
+    chunks[i].begin = (int)((long long)count * i / numChunks);
+    chunks[i].end = (int)((long long)count * (i + 1) / numChunks);
+  }
+  chunkCount = numChunks;
+  nextChunk = 0;
+  chunksDone = 0;
+  jobFunc = func;
+  jobData = data;
+  pthread_cond_broadcast(&workReady);
+
+  RunQueuedChunks(); // The caller works through the queue as well
+  while (chunksDone < chunkCount)
+    pthread_cond_wait(&workDone, &queueMutex);
+
+  chunkCount = 0;
+  pthread_mutex_unlock(&queueMutex);
+#endif
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+#if defined(JOB_SYSTEM_THREADED)
+
+static void *WorkerMain(void *arg) {
+  (void)arg;
+
+  pthread_mutex_lock(&queueMutex);
+  while (!quitWorkers) {
+    if (nextChunk < chunkCount)
+      RunQueuedChunks();
+    else
+      pthread_cond_wait(&workReady, &queueMutex);
+  }
+  pthread_mutex_unlock(&queueMutex);
+
+  return NULL;
+}
+
+// Claim and run chunks until the queue is empty
+// NOTE: Called and returns with queueMutex held
+static void RunQueuedChunks(void) {
+  while (nextChunk < chunkCount) {
+    JobChunk chunk = chunks[nextChunk++];
+    JobFunc func = jobFunc;
+    void *data = jobData;
+
+    pthread_mutex_unlock(&queueMutex);
+    func(data, chunk.begin, chunk.end);
+    pthread_mutex_lock(&queueMutex);
+
+    if (++chunksDone == chunkCount)
+      pthread_cond_signal(&workDone);
+  }
+}
+
+#endif
@@ -0,0 +1,51 @@
+/**********************************************************************************************
+ *
+ *   Job System - Small worker-thread pool for data-parallel loops
+ *
+ *   RunParallelFor() splits [0, count) into chunks, pushes them onto a fixed
+ *   job queue and blocks until every chunk has run. The calling thread takes
+ *   chunks too, so InitJobSystem(4) starts three workers. Jobs must only
+ *   write to the indices of their own chunk; anything order dependent is left
+ *   to the caller once RunParallelFor() returns.
+ *
+ *   Without InitJobSystem(), with one thread, or for ranges smaller than two
+ *   chunks the function is called once, inline, over the whole range. Web
+ *   builds always run inline.
+ *
+ *   NOTE: Only one thread may call RunParallelFor() at a time, and jobs must
+ *   not call it themselves.
+ *
+ **********************************************************************************************/
+
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define MAX_JOB_THREADS 16      // Calling thread included
+#define MAX_JOB_CHUNKS 256      // Queue size of one RunParallelFor() call
+#define JOB_CHUNKS_PER_THREAD 4 // Slack so uneven chunks still balance
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef void (*JobFunc)(void *data, int begin, int end);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//----------------------------------------------------------------------------------
+// Job System Functions Declaration
+//----------------------------------------------------------------------------------
+void InitJobSystem(int threadCount); // Clamped to [1, MAX_JOB_THREADS]
+void UnloadJobSystem(void);          // Joins the workers
+int GetJobThreadCount(void);
+void RunParallelFor(int count, int minChunkSize, JobFunc func, void *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // JOB_SYSTEM_H
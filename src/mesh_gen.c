@@ -0,0 +1,121 @@
+/**********************************************************************************************
+ *
+ *   Mesh Gen - CPU-only mesh generation
+ *
+ *   The cube uses the same vertex layout as raylib's GenMeshCube(); the
+ *   sphere is a plain UV sphere rather than par_shapes' parametric one.
+ *
+ **********************************************************************************************/
+
+#include "mesh_gen.h"
+#include <math.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Mesh Gen Functions Definition
+//----------------------------------------------------------------------------------
+
+Mesh GenCubeMeshData(float width, float height, float length) {
+  const float x = width / 2.0f;
+  const float y = height / 2.0f;
+  const float z = length / 2.0f;
+
+  const float vertices[] = {
+      -x, -y, z,  x,  -y, z,  x,  y,  z,  -x, y,  z,  // Front
+      -x, -y, -z, -x, y,  -z, x,  y,  -z, x,  -y, -z, // Back
+      -x, y,  -z, -x, y,  z,  x,  y,  z,  x,  y,  -z, // Top
+      -x, -y, -z, x,  -y, -z, x,  -y, z,  -x, -y, z,  // Bottom
+      x,  -y, -z, x,  y,  -z, x,  y,  z,  x,  -y, z,  // Right
+      -x, -y, -z, -x, -y, z,  -x, y,  z,  -x, y,  -z, // Left
+  };
+  const float texcoords[] = {
+      0, 0, 1, 0, 1, 1, 0, 1, // Front
+      1, 0, 1, 1, 0, 1, 0, 0, // Back
+      0, 1, 0, 0, 1, 0, 1, 1, // Top
+      1, 1, 0, 1, 0, 0, 1, 0, // Bottom
+      1, 0, 1, 1, 0, 1, 0, 0, // Right
+      0, 0, 1, 0, 1, 1, 0, 1, // Left
+  };
+  const float faceNormals[6][3] = {{0, 0, 1},  {0, 0, -1}, {0, 1, 0},
+                                   {0, -1, 0}, {1, 0, 0},  {-1, 0, 0}};
+
+  Mesh mesh = {0};
+  mesh.vertexCount = 24;
+  mesh.triangleCount = 12;
+  mesh.vertices = MemAlloc(sizeof(vertices));
+  mesh.texcoords = MemAlloc(sizeof(texcoords));
+  mesh.normals = MemAlloc(sizeof(float) * 3 * 24);
+  mesh.indices = MemAlloc(sizeof(unsigned short) * 36);
+  memcpy(mesh.vertices, vertices, sizeof(vertices));
+  memcpy(mesh.texcoords, texcoords, sizeof(texcoords));
+
+  for (int face = 0; face < 6; face++) {
+    for (int v = 0; v < 4; v++)
+      memcpy(&mesh.normals[(face * 4 + v) * 3], faceNormals[face],
+             sizeof(faceNormals[face]));
+
+    unsigned short first = (unsigned short)(face * 4);
+    unsigned short *indices = &mesh.indices[face * 6];
+    indices[0] = first;
+    indices[1] = first + 1;
+    indices[2] = first + 2;
+    indices[3] = first;
+    indices[4] = first + 2;
+    indices[5] = first + 3;
+  }
+
+  return mesh;
+}
+
+Mesh GenSphereMeshData(float radius, int rings, int slices) {
+  Mesh mesh = {0};
+  int columns = slices + 1;
+
+  mesh.vertexCount = (rings + 1) * columns;
+  mesh.triangleCount = rings * slices * 2;
+  mesh.vertices = MemAlloc(sizeof(float) * 3 * mesh.vertexCount);
+  mesh.normals = MemAlloc(sizeof(float) * 3 * mesh.vertexCount);
+  mesh.texcoords = MemAlloc(sizeof(float) * 2 * mesh.vertexCount);
+  mesh.indices = MemAlloc(sizeof(unsigned short) * 3 * mesh.triangleCount);
+
+  for (int ring = 0; ring <= rings; ring++) {
+    float phi = PI * ring / rings; // 0 at the +y pole
+    for (int slice = 0; slice <= slices; slice++) {
+      float theta = 2.0f * PI * slice / slices;
+      float normal[3] = {sinf(phi) * cosf(theta), cosf(phi),
+                         sinf(phi) * sinf(theta)};
+      int v = ring * columns + slice;
+
+      for (int axis = 0; axis < 3; axis++) {
+        mesh.normals[v * 3 + axis] = normal[axis];
+        mesh.vertices[v * 3 + axis] = normal[axis] * radius;
+      }
+      mesh.texcoords[v * 2] = (float)slice / slices;
+      mesh.texcoords[v * 2 + 1] = (float)ring / rings;
+    }
+  }
+
+  // Two counter-clockwise triangles per quad, seen from outside
+  unsigned short *indices = mesh.indices;
+  for (int ring = 0; ring < rings; ring++) {
+    for (int slice = 0; slice < slices; slice++) {
+      unsigned short top = (unsigned short)(ring * columns + slice);
+      unsigned short bottom = (unsigned short)(top + columns);
+      *indices++ = top;
+      *indices++ = top + 1;
+      *indices++ = bottom;
+      *indices++ = top + 1;
+      *indices++ = bottom + 1;
+      *indices++ = bottom;
+    }
+  }
+
+  return mesh;
+}
+
+void FreeMeshData(Mesh mesh) {
+  MemFree(mesh.vertices);
+  MemFree(mesh.texcoords);
+  MemFree(mesh.normals);
+  MemFree(mesh.indices);
+}
@@ -0,0 +1,42 @@
+/**********************************************************************************************
+ *
+ *   Mesh Gen - CPU-only mesh generation
+ *
+ *   Counterparts of GenMeshCube() and GenMeshSphere() that stop before
+ *   UploadMesh(), so they can run off the main thread. The arrays come from
+ *   MemAlloc(), which lets UnloadMesh()/UnloadModel() free them once the mesh
+ *   has been uploaded; FreeMeshData() frees a mesh that never was.
+ *
+ *   The asset cache keeps generated meshes on disk, keyed by their
+ *   parameters and MESH_GEN_VERSION. Any change to what these functions
+ *   output (vertices, winding, normals, texcoords) must bump it, or stale
+ *   meshes keep being served from the cache.
+ *
+ **********************************************************************************************/
+
+#ifndef MESH_GEN_H
+#define MESH_GEN_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define MESH_GEN_VERSION 1 // Bump whenever the generated meshes change
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//----------------------------------------------------------------------------------
+// Mesh Gen Functions Declaration
+//----------------------------------------------------------------------------------
+Mesh GenCubeMeshData(float width, float height, float length);
+Mesh GenSphereMeshData(float radius, int rings, int slices);
+void FreeMeshData(Mesh mesh); // Only for meshes that were never uploaded
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MESH_GEN_H
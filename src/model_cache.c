@@ -0,0 +1,222 @@
+/**********************************************************************************************
+ *
+ *   Model Cache - Shared, reference-counted models for gameplay entities
+ *
+ *   See model_cache.h for the ownership rules.
+ *
+ **********************************************************************************************/
+
+#include "model_cache.h"
+#include "asset_cache.h"
+#include "frame_arena.h"
+#include "raylib.h"
+#include "resource_tracker.h"
+#include <math.h>
+#include <stdlib.h>
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct ModelCacheEntry {
+  bool used;
+  ModelKind kind;
+  int paramKey; // Quantized generation parameter
+  int refCount;
+  bool loaded; // Model generated and uploaded
+  Model model;
+} ModelCacheEntry;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static ModelCacheEntry entries[MAX_CACHED_MODELS] = {0};
+static ModelCacheStats stats = {0};
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static int QuantizeParam(ModelKind kind, float param);
+static Model GenerateModel(ModelKind kind, int paramKey);
+static void UnloadEntry(ModelCacheEntry *entry);
+
+//----------------------------------------------------------------------------------
+// Model Cache Functions Definition
+//----------------------------------------------------------------------------------
+
+ModelHandle AcquireModel(ModelKind kind, float param) {
+  int paramKey = QuantizeParam(kind, param);
+  int freeSlot = MODEL_HANDLE_INVALID;
+
+  for (int i = 0; i < MAX_CACHED_MODELS; i++) {
+    if (!entries[i].used) {
+      if (freeSlot == MODEL_HANDLE_INVALID)
+        freeSlot = i;
+      continue;
+    }
+    if ((entries[i].kind == kind) && (entries[i].paramKey == paramKey)) {
+      entries[i].refCount++;
+      stats.liveRefs++;
+      return i;
+    }
+  }
+
+  if (freeSlot == MODEL_HANDLE_INVALID) {
+    // Nearest size of the same kind, drawn rescaled by GetModelScale()
+    int nearest = MODEL_HANDLE_INVALID;
+    for (int i = 0; i < MAX_CACHED_MODELS; i++) {
+      if (entries[i].used && (entries[i].kind == kind) &&
+          ((nearest == MODEL_HANDLE_INVALID) ||
+           (abs(entries[i].paramKey - paramKey) <
+            abs(entries[nearest].paramKey - paramKey))))
+        nearest = i;
+    }
+    if ((nearest == MODEL_HANDLE_INVALID) || (stats.fallbacks == 0))
+      TraceLog(LOG_WARNING,
+               "MODELCACHE: No free slot for kind %i (key %i), %s", kind,
+               paramKey,
+               (nearest != MODEL_HANDLE_INVALID) ? "using the nearest size"
+                                                 : "not drawn");
+    if (nearest == MODEL_HANDLE_INVALID)
+      return MODEL_HANDLE_INVALID;
+
+    entries[nearest].refCount++;
+    stats.liveRefs++;
+    stats.fallbacks++;
+    return nearest;
+  }
+
+  entries[freeSlot] = (ModelCacheEntry){
+      .used = true,
+      .kind = kind,
+      .paramKey = paramKey,
+      .refCount = 1,
+  };
+  stats.liveRefs++;
+
+  return freeSlot;
+}
+
+void ReleaseModel(ModelHandle handle) {
+  if ((handle < 0) || (handle >= MAX_CACHED_MODELS) || !entries[handle].used)
+    return;
+
+  if (entries[handle].refCount > 0) {
+    entries[handle].refCount--;
+    stats.liveRefs--;
+  }
+}
+
+Model GetCachedModel(ModelHandle handle) {
+  if ((handle < 0) || (handle >= MAX_CACHED_MODELS) || !entries[handle].used)
+    return (Model){0};
+
+  ModelCacheEntry *entry = &entries[handle];
+  if (!entry->loaded) {
+    entry->model = GenerateModel(entry->kind, entry->paramKey);
+    entry->loaded = true;
+    NoteHeapAllocation("model cache", GetModelBytes(entry->model));
+    stats.loads++;
+    stats.liveModels++;
+  }
+
+  return entry->model;
+}
+
+bool GetPendingModel(ModelHandle handle, ModelKind *kind, float *param) {
+  if ((handle < 0) || (handle >= MAX_CACHED_MODELS) ||
+      !entries[handle].used || entries[handle].loaded)
+    return false;
+
+  *kind = entries[handle].kind;
+  *param = (entries[handle].kind == MODEL_KIND_ROCK)
+               ? (float)entries[handle].paramKey / ROCK_RADIUS_QUANTUM
+               : 0.0f;
+  return true;
+}
+
+bool AdoptCachedModel(ModelHandle handle, Model model) {
+  if ((handle < 0) || (handle >= MAX_CACHED_MODELS) ||
+      !entries[handle].used || entries[handle].loaded)
+    return false;
+
+  entries[handle].model = model;
+  entries[handle].loaded = true;
+  stats.loads++;
+  stats.liveModels++;
+  return true;
+}
+
+float GetModelScale(ModelHandle handle, float param) {
+  if ((handle < 0) || (handle >= MAX_CACHED_MODELS) || !entries[handle].used)
+    return 1.0f;
+
+  switch (entries[handle].kind) {
+  case MODEL_KIND_ROCK:
+    if (entries[handle].paramKey > 0)
+      return param * ROCK_RADIUS_QUANTUM / entries[handle].paramKey;
+    return 1.0f;
+  default:
+    return 1.0f;
+  }
+}
+
+void TrimModelCache(void) {
+  for (int i = 0; i < MAX_CACHED_MODELS; i++) {
+    if (entries[i].used && (entries[i].refCount == 0))
+      UnloadEntry(&entries[i]);
+  }
+}
+
+void UnloadModelCache(void) {
+  for (int i = 0; i < MAX_CACHED_MODELS; i++) {
+    if (entries[i].used) {
+      stats.liveRefs -= entries[i].refCount;
+      UnloadEntry(&entries[i]);
+    }
+  }
+}
+
+ModelCacheStats GetModelCacheStats(void) { return stats; }
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+static int QuantizeParam(ModelKind kind, float param) {
+  switch (kind) {
+  case MODEL_KIND_ROCK:
+    return (int)roundf(param * ROCK_RADIUS_QUANTUM);
+  default:
+    return 0;
+  }
+}
+
+static Model GenerateModel(ModelKind kind, int paramKey) {
+  Mesh mesh = {0};
+
+  switch (kind) {
+  case MODEL_KIND_BULLET:
+    mesh = LoadCachedCubeMesh(BULLET_MODEL_WIDTH, BULLET_MODEL_WIDTH,
+                              BULLET_MODEL_LENGTH);
+    break;
+  case MODEL_KIND_ROCK:
+    mesh = LoadCachedSphereMesh((float)paramKey / ROCK_RADIUS_QUANTUM,
+                                ROCK_MODEL_RINGS, ROCK_MODEL_SLICES);
+    break;
+  default:
+    break;
+  }
+
+  UploadMesh(&mesh, false);
+  return TrackModel(LoadModelFromMesh(mesh),
+                    (kind == MODEL_KIND_BULLET) ? "bullet" : "rock");
+}
+
+static void UnloadEntry(ModelCacheEntry *entry) {
+  if (entry->loaded) {
+    UnloadModelTracked(entry->model);
+    stats.unloads++;
+    stats.liveModels--;
+  }
+  *entry = (ModelCacheEntry){0};
+}
@@ -0,0 +1,87 @@
+/**********************************************************************************************
+ *
+ *   Model Cache - Shared, reference-counted models for gameplay entities
+ *
+ *   Entities no longer own a Model. They hold a ModelHandle obtained from
+ *   AcquireModel() and give it back with ReleaseModel(). Models are keyed by
+ *   kind and a quantized generation parameter, so every bullet shares one cube
+ *   and every rock of the same (quantized) radius shares one sphere.
+ *
+ *   Acquiring and releasing is pure bookkeeping and never touches the GPU;
+ *   the mesh is generated, or read back from the asset cache, and uploaded
+ *   the first time GetCachedModel() asks for it, so code without a graphics
+ *   context can still hold handles. A screen that loads ahead of time can
+ *   instead build the model elsewhere, from GetPendingModel() and the
+ *   BULLET_MODEL_* and ROCK_MODEL_* shapes, and hand it over with
+ *   AdoptCachedModel().
+ *
+ *   Unreferenced models stay resident until TrimModelCache() is called, so a
+ *   stream of short-lived entities never re-uploads the same mesh. When every
+ *   slot is taken, AcquireModel() falls back to the cached model of the same
+ *   kind with the nearest parameter. Either way the model can be off the
+ *   requested size; GetModelScale() gives the scale that corrects it, so what
+ *   is drawn matches what collides.
+ *
+ **********************************************************************************************/
+
+#ifndef MODEL_CACHE_H
+#define MODEL_CACHE_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define MAX_CACHED_MODELS 64
+#define MODEL_HANDLE_INVALID -1
+
+// Rock radius is quantized to 1/ROCK_RADIUS_QUANTUM units before lookup
+#define ROCK_RADIUS_QUANTUM 8
+
+// Generated shapes: a cube for bullets, a sphere of the rock's radius
+#define BULLET_MODEL_WIDTH 0.25f
+#define BULLET_MODEL_LENGTH 2.0f
+#define ROCK_MODEL_RINGS 10
+#define ROCK_MODEL_SLICES 10
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum ModelKind { MODEL_KIND_BULLET = 0, MODEL_KIND_ROCK } ModelKind;
+
+typedef int ModelHandle;
+
+typedef struct ModelCacheStats {
+  int loads;      // Models generated and uploaded since startup
+  int unloads;    // Models unloaded since startup
+  int liveModels; // Models currently uploaded
+  int liveRefs;   // Outstanding references over all resident models
+  int fallbacks;  // Acquires served by a nearest-size model, cache full
+} ModelCacheStats;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//----------------------------------------------------------------------------------
+// Model Cache Functions Declaration
+//----------------------------------------------------------------------------------
+ModelHandle AcquireModel(ModelKind kind, float param); // Get a reference
+void ReleaseModel(ModelHandle handle);                  // Drop a reference
+Model GetCachedModel(ModelHandle handle); // Generates the model on first use
+// Kind and quantized param of a model not generated yet, false otherwise
+bool GetPendingModel(ModelHandle handle, ModelKind *kind, float *param);
+// Takes ownership of a model built from GetPendingModel(); false when the
+// entry was generated meanwhile, the caller still owns the model then
+bool AdoptCachedModel(ModelHandle handle, Model model);
+// Uniform scale from the cached model to the param it was acquired with
+float GetModelScale(ModelHandle handle, float param);
+void TrimModelCache(void);   // Unload every model with no references left
+void UnloadModelCache(void); // Unload everything, references included
+ModelCacheStats GetModelCacheStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MODEL_CACHE_H
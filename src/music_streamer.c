@@ -0,0 +1,287 @@
+/**********************************************************************************************
+ *
+ *   Music Streamer - Background music decoded and queued off the main thread
+ *
+ *   See music_streamer.h for which thread touches what.
+ *
+ **********************************************************************************************/
+
+#include "music_streamer.h"
+#include "asset_pack.h"
+#include "raylib.h"
+#include <string.h>
+
+#if !defined(PLATFORM_WEB)
+#include <pthread.h>
+#include <time.h>
+#define STB_VORBIS_HEADER_ONLY
+#include "stb_vorbis.c" // NOTE: Declarations only, raylib links the decoder
+#define MUSIC_STREAMER_THREADED
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define RING_MASK (MUSIC_RING_FRAMES - 1)
+#define RING_MAX_CHANNELS 2 // Anything wider is downmixed by the decoder
+
+// Ring positions count frames since init and wrap freely; only their
+// difference matters
+#define LOAD_ACQUIRE(x) __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(x, v) __atomic_store_n(&(x), (v), __ATOMIC_RELEASE)
+#define ADD_RELAXED(x, v) __atomic_fetch_add(&(x), (v), __ATOMIC_RELAXED)
+#define LOAD_RELAXED(x) __atomic_load_n(&(x), __ATOMIC_RELAXED)
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static bool threaded = false;
+static float musicVolume = 1.0f;
+static Music fallbackMusic = {0};
+
+#if defined(MUSIC_STREAMER_THREADED)
+static AudioStream stream = {0};
+static stb_vorbis *decoder = NULL;
+static unsigned char *fileData = NULL; // Loose file only, packs stay mapped
+static int channels = 0;
+
+static short ring[MUSIC_RING_FRAMES * RING_MAX_CHANNELS] = {0};
+static unsigned int writePos = 0; // Stored by the decoder thread only
+static unsigned int readPos = 0;  // Stored by the audio callback only
+static unsigned int underruns = 0;
+static unsigned int silentFrames = 0;
+
+static pthread_t decoderThread;
+static pthread_mutex_t wakeMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t wakeDecoder = PTHREAD_COND_INITIALIZER;
+static bool quitDecoder = false; // Guarded by wakeMutex
+#endif
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+#if defined(MUSIC_STREAMER_THREADED)
+static bool OpenDecoder(const char *fileName);
+static void CloseDecoder(void);
+static void FillRing(void);
+static void ReadRing(void *bufferData, unsigned int frames);
+static void *DecoderMain(void *arg);
+#endif
+
+//----------------------------------------------------------------------------------
+// Music Streamer Functions Definition
+//----------------------------------------------------------------------------------
+
+void InitMusicStreamer(const char *fileName) {
+#if defined(MUSIC_STREAMER_THREADED)
+  if (IsFileExtension(fileName, ".ogg") && OpenDecoder(fileName)) {
+    stb_vorbis_info info = stb_vorbis_get_info(decoder);
+    channels = (info.channels > 1) ? RING_MAX_CHANNELS : 1;
+    writePos = 0;
+    readPos = 0;
+    underruns = 0;
+    silentFrames = 0;
+    FillRing(); // Full before the first callback asks for anything
+
+    quitDecoder = false;
+    if (pthread_create(&decoderThread, NULL, DecoderMain, NULL) == 0) {
+      stream = LoadAudioStream(info.sample_rate, 16, channels);
+      SetAudioStreamCallback(stream, ReadRing);
+      SetAudioStreamVolume(stream, musicVolume);
+      PlayAudioStream(stream);
+      threaded = true;
+      TraceLog(LOG_INFO, "MUSIC: [%s] Decoding on its own thread", fileName);
+      return;
+    }
+
+    TraceLog(LOG_WARNING, "MUSIC: Failed to start the decoder thread");
+    CloseDecoder();
+  }
+#endif
+
+  fallbackMusic = LoadPackedMusicStream(fileName);
+  SetMusicVolume(fallbackMusic, musicVolume);
+  PlayMusicStream(fallbackMusic);
+  TraceLog(LOG_INFO, "MUSIC: [%s] Decoding on the main thread", fileName);
+}
+
+void UnloadMusicStreamer(void) {
+#if defined(MUSIC_STREAMER_THREADED)
+  if (threaded) {
+    // NOTE: Once the stream is unloaded the callback is not running anymore
+    UnloadAudioStream(stream);
+
+    pthread_mutex_lock(&wakeMutex);
+    quitDecoder = true;
+    pthread_cond_signal(&wakeDecoder);
+    pthread_mutex_unlock(&wakeMutex);
+    pthread_join(decoderThread, NULL);
+
+    CloseDecoder();
+    TraceLog(LOG_INFO, "MUSIC: %u underrun(s), %u frame(s) of silence",
+             LOAD_RELAXED(underruns), LOAD_RELAXED(silentFrames));
+    threaded = false;
+  }
+#endif
+
+  if (fallbackMusic.stream.buffer != NULL)
+    UnloadMusicStream(fallbackMusic);
+  fallbackMusic = (Music){0};
+}
+
+void UpdateMusicStreamer(void) {
+  if (!threaded && (fallbackMusic.stream.buffer != NULL))
+    UpdateMusicStream(fallbackMusic);
+}
+
+void SetMusicStreamerVolume(float volume) {
+  musicVolume = volume;
+#if defined(MUSIC_STREAMER_THREADED)
+  if (threaded)
+    SetAudioStreamVolume(stream, volume);
+#endif
+  if (fallbackMusic.stream.buffer != NULL)
+    SetMusicVolume(fallbackMusic, volume);
+}
+
+MusicStreamerStats GetMusicStreamerStats(void) {
+  MusicStreamerStats stats = {.threaded = threaded};
+
+#if defined(MUSIC_STREAMER_THREADED)
+  if (threaded) {
+    unsigned int read = LOAD_ACQUIRE(readPos);
+    stats.capacity = MUSIC_RING_FRAMES;
+    stats.buffered = (int)(LOAD_ACQUIRE(writePos) - read);
+    stats.underruns = LOAD_RELAXED(underruns);
+    stats.silentFrames = LOAD_RELAXED(silentFrames);
+  }
+#endif
+
+  return stats;
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+#if defined(MUSIC_STREAMER_THREADED)
+
+// Decode from the pack mapping when the file is packed, else load it whole;
+// the compressed file is small, the decoded music would not be
+static bool OpenDecoder(const char *fileName) {
+  int dataSize = 0;
+  const unsigned char *data = GetPackedFile(fileName, &dataSize);
+  if (data == NULL) {
+    fileData = LoadFileData(fileName, &dataSize);
+    data = fileData;
+  }
+
+  if (data != NULL) {
+    int error = 0;
+    decoder = stb_vorbis_open_memory(data, dataSize, &error, NULL);
+    if (decoder == NULL)
+      TraceLog(LOG_WARNING, "MUSIC: [%s] Not a valid OGG stream (error %d)",
+               fileName, error);
+  }
+
+  if (decoder == NULL)
+    CloseDecoder();
+  return (decoder != NULL);
+}
+
+static void CloseDecoder(void) {
+  if (decoder != NULL)
+    stb_vorbis_close(decoder);
+  decoder = NULL;
+
+  if (fileData != NULL)
+    UnloadFileData(fileData);
+  fileData = NULL;
+}
+
+// Decode until the ring is full, rewinding at the end of the music
+// NOTE: Producer side, only the decoder thread calls it once it runs
+static void FillRing(void) {
+  unsigned int write = writePos;
+  bool rewound = false;
+
+  for (;;) {
+    unsigned int space = MUSIC_RING_FRAMES - (write - LOAD_ACQUIRE(readPos));
+    if (space == 0)
+      break;
+
+    // Decode straight into the ring, up to where it wraps
+    unsigned int offset = write & RING_MASK;
+    unsigned int span = MUSIC_RING_FRAMES - offset;
+    if (span > space)
+      span = space;
+    if (span > MUSIC_DECODE_FRAMES)
+      span = MUSIC_DECODE_FRAMES;
+
+    int decoded = stb_vorbis_get_samples_short_interleaved(
+        decoder, channels, &ring[offset * channels], (int)span * channels);
+    if (decoded <= 0) {
+      if (rewound)
+        break; // Nothing decodes even from the start, retry next wake-up
+      stb_vorbis_seek_start(decoder);
+      rewound = true;
+      continue;
+    }
+
+    rewound = false;
+    write += (unsigned int)decoded;
+    STORE_RELEASE(writePos, write);
+  }
+}
+
+// Consumer side, called by raylib on the audio device thread: must not
+// block, so whatever is missing is played as silence
+static void ReadRing(void *bufferData, unsigned int frames) {
+  short *out = (short *)bufferData;
+  unsigned int read = readPos;
+  unsigned int available = LOAD_ACQUIRE(writePos) - read;
+  unsigned int count = (frames < available) ? frames : available;
+
+  unsigned int offset = read & RING_MASK;
+  unsigned int first = MUSIC_RING_FRAMES - offset;
+  if (first > count)
+    first = count;
+  memcpy(out, &ring[offset * channels], first * channels * sizeof(short));
+  memcpy(out + first * channels, ring,
+         (count - first) * channels * sizeof(short));
+  STORE_RELEASE(readPos, read + count);
+
+  if (count < frames) {
+    memset(out + count * channels, 0,
+           (frames - count) * channels * sizeof(short));
+    ADD_RELAXED(underruns, 1);
+    ADD_RELAXED(silentFrames, frames - count);
+  }
+}
+
+static void *DecoderMain(void *arg) {
+  (void)arg;
+
+  pthread_mutex_lock(&wakeMutex);
+  while (!quitDecoder) {
+    pthread_mutex_unlock(&wakeMutex);
+    FillRing();
+    pthread_mutex_lock(&wakeMutex);
+
+    // Nobody signals a drained ring, the callback must not lock; a short
+    // nap is well within the ring's length
+    struct timespec wake;
+    clock_gettime(CLOCK_REALTIME, &wake);
+    wake.tv_nsec += MUSIC_REFILL_INTERVAL * 1000000L;
+    if (wake.tv_nsec >= 1000000000L) {
+      wake.tv_sec++;
+      wake.tv_nsec -= 1000000000L;
+    }
+    if (!quitDecoder)
+      pthread_cond_timedwait(&wakeDecoder, &wakeMutex, &wake);
+  }
+  pthread_mutex_unlock(&wakeMutex);
+
+  return NULL;
+}
+
+#endif
@@ -0,0 +1,65 @@
+/**********************************************************************************************
+ *
+ *   Music Streamer - Background music decoded and queued off the main thread
+ *
+ *   A decoder thread owns the OGG decoder and keeps a single-producer,
+ *   single-consumer ring of PCM frames topped up. The audio device pulls
+ *   from the ring through the AudioStream callback, on the mixer thread, so
+ *   the main loop neither decodes nor refills buffers and a long frame no
+ *   longer starves the music. Neither side ever locks: each one only writes
+ *   its own position, published with acquire/release atomics.
+ *
+ *   When the callback finds the ring short it plays silence for the missing
+ *   frames and counts an underrun. The music loops.
+ *
+ *   The decoder is the stb_vorbis copy built into raylib, which needs
+ *   SUPPORT_FILEFORMAT_OGG (on by default). Web builds, non-OGG files and
+ *   files the decoder rejects fall back to a plain raylib Music refilled by
+ *   UpdateMusicStreamer() on the calling thread.
+ *
+ *   NOTE: Packed music is decoded straight from the pack mapping, so
+ *   CloseAssetPack() must come after UnloadMusicStreamer().
+ *
+ **********************************************************************************************/
+
+#ifndef MUSIC_STREAMER_H
+#define MUSIC_STREAMER_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define MUSIC_RING_FRAMES 32768  // Power of two, about 0.75 s at 44.1 kHz
+#define MUSIC_DECODE_FRAMES 4096 // Largest span decoded in one go
+#define MUSIC_REFILL_INTERVAL 10 // Milliseconds the decoder sleeps when full
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct MusicStreamerStats {
+  bool threaded;             // False when running the main-thread fallback
+  int capacity;              // Ring size in frames
+  int buffered;              // Frames decoded and not yet played
+  unsigned int underruns;    // Callbacks that ran out of frames, since init
+  unsigned int silentFrames; // Frames of silence those callbacks played
+} MusicStreamerStats;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//----------------------------------------------------------------------------------
+// Music Streamer Functions Declaration
+//----------------------------------------------------------------------------------
+void InitMusicStreamer(const char *fileName); // Starts playing right away
+void UnloadMusicStreamer(void);               // Joins the decoder thread
+void UpdateMusicStreamer(void);               // Only does work in the fallback
+void SetMusicStreamerVolume(float volume);
+MusicStreamerStats GetMusicStreamerStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MUSIC_STREAMER_H
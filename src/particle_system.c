@@ -0,0 +1,270 @@
+/**********************************************************************************************
+ *
+ *   Particle System - Cosmetic sparks, explosions and trails on the play field
+ *
+ *   See particle_system.h for the ring buffer and batching rules.
+ *
+ **********************************************************************************************/
+
+#include "particle_system.h"
+#include "raylib.h"
+#include "rlgl.h"
+#include "tagged_heap.h"
+#include <math.h>
+#include <stddef.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PARTICLES_SSE2
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define PARTICLE_DRAG 2.0f       // Velocity lost per second, exponential
+#define PARTICLE_HEIGHT 0.5f     // Above the play-field plane
+#define PARTICLE_DRAW_CHUNK 1024 // Quads written per rlBegin()/rlEnd()
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct ParticleEffectDesc {
+  int count; // Particles per emission at scale 1
+  float speedMin, speedMax;
+  float spread; // Radians, centred on the emission direction
+  float lifeMin, lifeMax;
+  float size;                 // Quad half extent at birth, halves by death
+  Color startColor, endColor; // Blended over the lifetime, alpha fades out
+} ParticleEffectDesc;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static const ParticleEffectDesc effects[PARTICLE_EFFECT_COUNT] = {
+    [PARTICLE_EFFECT_IMPACT] = {6, 4.0f, 10.0f, PI / 2, 0.1f, 0.25f, 0.12f,
+                                {255, 255, 255, 255}, {253, 249, 0, 255}},
+    [PARTICLE_EFFECT_EXPLOSION] = {24, 1.0f, 8.0f, 2 * PI, 0.4f, 0.9f, 0.3f,
+                                   {255, 161, 0, 255}, {80, 80, 80, 255}},
+    [PARTICLE_EFFECT_TRAIL] = {2, 1.0f, 3.0f, PI / 6, 0.2f, 0.4f, 0.15f,
+                               {102, 191, 255, 255}, {0, 82, 172, 255}},
+};
+
+// Ring buffer, one array per field, occupied span [head, head + count)
+static float *posX = NULL;
+static float *posY = NULL;
+static float *velX = NULL;
+static float *velY = NULL;
+static float *age = NULL;
+static float *invLifeTime = NULL; // Age times this is 0 at birth, 1 at death
+static unsigned char *effectOf = NULL;
+static int capacity = 0;
+static int head = 0;
+static int count = 0;
+
+static unsigned int rngState = 0x2545f491; // Separate from the simulation's
+static ParticleStats stats = {0};
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static int NextSlot(void);
+static float RandomUnit(void);
+static void IntegrateSpan(int begin, int end, float dt, float damping);
+static void DrawSpan(int begin, int end);
+
+//----------------------------------------------------------------------------------
+// Particle System Functions Definition
+//----------------------------------------------------------------------------------
+
+void InitParticleSystem(int newCapacity) {
+  UnloadParticleSystem();
+
+  capacity = (newCapacity > 0) ? newCapacity : PARTICLE_DEFAULT_CAPACITY;
+  posX = TaggedAlloc(MEM_TAG_PARTICLES, sizeof(float) * capacity);
+  posY = TaggedAlloc(MEM_TAG_PARTICLES, sizeof(float) * capacity);
+  velX = TaggedAlloc(MEM_TAG_PARTICLES, sizeof(float) * capacity);
+  velY = TaggedAlloc(MEM_TAG_PARTICLES, sizeof(float) * capacity);
+  age = TaggedAlloc(MEM_TAG_PARTICLES, sizeof(float) * capacity);
+  invLifeTime = TaggedAlloc(MEM_TAG_PARTICLES, sizeof(float) * capacity);
+  effectOf = TaggedAlloc(MEM_TAG_PARTICLES, sizeof(unsigned char) * capacity);
+  stats = (ParticleStats){.capacity = capacity};
+}
+
+void UnloadParticleSystem(void) {
+  TaggedFree(posX);
+  TaggedFree(posY);
+  TaggedFree(velX);
+  TaggedFree(velY);
+  TaggedFree(age);
+  TaggedFree(invLifeTime);
+  TaggedFree(effectOf);
+  posX = posY = velX = velY = age = invLifeTime = NULL;
+  effectOf = NULL;
+  capacity = 0;
+  ClearParticles();
+}
+
+void ClearParticles(void) {
+  head = 0;
+  count = 0;
+}
+
+void EmitParticles(ParticleEffect effect, Vector2 pos, float dir,
+                   float scale) {
+  if ((capacity == 0) || (effect < 0) || (effect >= PARTICLE_EFFECT_COUNT))
+    return;
+
+  const ParticleEffectDesc *desc = &effects[effect];
+  int emitCount = (int)(desc->count * scale + 0.5f);
+  for (int i = 0; i < emitCount; i++) {
+    float angle = dir + desc->spread * (RandomUnit() - 0.5f);
+    float speed =
+        desc->speedMin + (desc->speedMax - desc->speedMin) * RandomUnit();
+    float lifeTime =
+        desc->lifeMin + (desc->lifeMax - desc->lifeMin) * RandomUnit();
+
+    int slot = NextSlot();
+    posX[slot] = pos.x;
+    posY[slot] = pos.y;
+    velX[slot] = speed * cosf(angle);
+    velY[slot] = speed * sinf(angle);
+    age[slot] = 0.0f;
+    invLifeTime[slot] = 1.0f / lifeTime;
+    effectOf[slot] = (unsigned char)effect;
+  }
+}
+
+void UpdateParticles(float dt) {
+  float damping = expf(-PARTICLE_DRAG * dt);
+
+  // The occupied span wraps around the end of the arrays at most once
+  int end = head + count;
+  IntegrateSpan(head, (end < capacity) ? end : capacity, dt, damping);
+  if (end > capacity)
+    IntegrateSpan(0, end - capacity, dt, damping);
+
+  // Dead particles further in wait until everything older has died too
+  while ((count > 0) && (age[head] * invLifeTime[head] >= 1.0f)) {
+    head = (head + 1 == capacity) ? 0 : head + 1;
+    count--;
+  }
+  stats.occupied = count;
+}
+
+void DrawParticles(void) {
+  stats.live = 0;
+  if (count == 0) {
+    stats.batches = 0;
+    return;
+  }
+
+  // Additive, and without depth writes so overlapping quads all show
+  BeginBlendMode(BLEND_ADDITIVE);
+  rlDisableDepthMask();
+
+  int end = head + count;
+  DrawSpan(head, (end < capacity) ? end : capacity);
+  if (end > capacity)
+    DrawSpan(0, end - capacity);
+
+  EndBlendMode(); // NOTE: Flushes the batch before depth writes come back
+  rlEnableDepthMask();
+
+  stats.batches = (stats.live + RL_DEFAULT_BATCH_BUFFER_ELEMENTS - 1) /
+                  RL_DEFAULT_BATCH_BUFFER_ELEMENTS;
+}
+
+ParticleStats GetParticleStats(void) { return stats; }
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+// A full ring hands out its oldest slot
+static int NextSlot(void) {
+  int slot = head + count;
+  if (slot >= capacity)
+    slot -= capacity;
+
+  if (count == capacity) {
+    if (age[head] * invLifeTime[head] < 1.0f)
+      stats.overwritten++;
+    head = (head + 1 == capacity) ? 0 : head + 1;
+  } else {
+    count++;
+  }
+
+  return slot;
+}
+
+// xorshift32 in [0, 1)
+static float RandomUnit(void) {
+  unsigned int x = rngState;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  rngState = x;
+
+  return (x >> 8) * (1.0f / 16777216.0f);
+}
+
+// Plain arithmetic with no branches, four particles a step where SSE2 is
+// available, scalar for the rest
+static void IntegrateSpan(int begin, int end, float dt, float damping) {
+  int i = begin;
+
+#if defined(PARTICLES_SSE2)
+  const __m128 vdt = _mm_set1_ps(dt);
+  const __m128 vdamping = _mm_set1_ps(damping);
+  for (; i + 4 <= end; i += 4) {
+    __m128 vx = _mm_loadu_ps(velX + i);
+    __m128 vy = _mm_loadu_ps(velY + i);
+    _mm_storeu_ps(posX + i,
+                  _mm_add_ps(_mm_loadu_ps(posX + i), _mm_mul_ps(vx, vdt)));
+    _mm_storeu_ps(posY + i,
+                  _mm_add_ps(_mm_loadu_ps(posY + i), _mm_mul_ps(vy, vdt)));
+    _mm_storeu_ps(velX + i, _mm_mul_ps(vx, vdamping));
+    _mm_storeu_ps(velY + i, _mm_mul_ps(vy, vdamping));
+    _mm_storeu_ps(age + i, _mm_add_ps(_mm_loadu_ps(age + i), vdt));
+  }
+#endif
+
+  for (; i < end; i++) {
+    posX[i] += velX[i] * dt;
+    posY[i] += velY[i] * dt;
+    velX[i] *= damping;
+    velY[i] *= damping;
+    age[i] += dt;
+  }
+}
+
+static void DrawSpan(int begin, int end) {
+  for (int chunk = begin; chunk < end; chunk += PARTICLE_DRAW_CHUNK) {
+    int chunkEnd =
+        (end - chunk > PARTICLE_DRAW_CHUNK) ? chunk + PARTICLE_DRAW_CHUNK : end;
+
+    // Flushes up front if the chunk would not fit, never in the middle
+    rlCheckRenderBatchLimit(4 * (chunkEnd - chunk));
+    rlBegin(RL_QUADS);
+    for (int i = chunk; i < chunkEnd; i++) {
+      float t = age[i] * invLifeTime[i];
+      if (t >= 1.0f)
+        continue;
+
+      const ParticleEffectDesc *desc = &effects[effectOf[i]];
+      float fade = 1.0f - t;
+      float half = desc->size * (1.0f - 0.5f * t);
+      rlColor4ub(
+          (unsigned char)(desc->startColor.r * fade + desc->endColor.r * t),
+          (unsigned char)(desc->startColor.g * fade + desc->endColor.g * t),
+          (unsigned char)(desc->startColor.b * fade + desc->endColor.b * t),
+          (unsigned char)(255.0f * fade));
+      rlVertex3f(posX[i] - half, PARTICLE_HEIGHT, posY[i] - half);
+      rlVertex3f(posX[i] - half, PARTICLE_HEIGHT, posY[i] + half);
+      rlVertex3f(posX[i] + half, PARTICLE_HEIGHT, posY[i] + half);
+      rlVertex3f(posX[i] + half, PARTICLE_HEIGHT, posY[i] - half);
+      stats.live++;
+    }
+    rlEnd();
+  }
+}
@@ -0,0 +1,185 @@
+/**********************************************************************************************
+ *
+ *   Profiler - Per-frame phase timings with an in-game overlay
+ *
+ *   See profiler.h for how zones are recorded.
+ *
+ **********************************************************************************************/
+
+#include "profiler.h"
+#include "raylib.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(_WIN32)
+// NOTE: Declared here instead of including windows.h, which clashes with
+// raylib.h
+__declspec(dllimport) int __stdcall QueryPerformanceCounter(
+    unsigned long long *lpPerformanceCount);
+__declspec(dllimport) int __stdcall QueryPerformanceFrequency(
+    unsigned long long *lpFrequency);
+#else
+#include <time.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static const char *zoneNames[PROFILE_ZONE_COUNT] = {
+    "frame",    "input",   "bullets",  "rocks",     "collisions",
+    "spawning", "draw_3d", "draw_hud", "particles", "draw_fx",
+    "music",    "transition",
+};
+
+static float history[PROFILE_HISTORY][PROFILE_ZONE_COUNT] = {0}; // In ms
+static int historyNext = 0;  // Slot the next completed frame goes to
+static int historyCount = 0; // Valid frames in the ring buffer
+static double zoneStart[PROFILE_ZONE_COUNT] = {0};
+static double zoneAccum[PROFILE_ZONE_COUNT] = {0};
+static double lastFrameStart = 0.0;
+static bool overlayVisible = false;
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static int CompareFloats(const void *a, const void *b);
+
+//----------------------------------------------------------------------------------
+// Profiler Functions Definition
+//----------------------------------------------------------------------------------
+
+double GetProfilerTime(void) {
+#if defined(_WIN32)
+  static unsigned long long frequency = 0;
+  unsigned long long counter = 0;
+  if (frequency == 0)
+    QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+  return (double)counter / (double)frequency;
+#else
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + now.tv_nsec * 1e-9;
+#endif
+}
+
+void BeginProfilerFrame(void) {
+  double now = GetProfilerTime();
+
+  zoneAccum[PROFILE_ZONE_FRAME] =
+      (lastFrameStart > 0.0) ? now - lastFrameStart : 0.0;
+  lastFrameStart = now;
+}
+
+void EndProfilerFrame(void) {
+  for (int zone = 0; zone < PROFILE_ZONE_COUNT; zone++) {
+    history[historyNext][zone] = (float)(zoneAccum[zone] * 1000.0);
+    zoneAccum[zone] = 0.0;
+  }
+
+  historyNext = (historyNext + 1) % PROFILE_HISTORY;
+  if (historyCount < PROFILE_HISTORY)
+    historyCount++;
+}
+
+void BeginProfileZone(ProfileZone zone) { zoneStart[zone] = GetProfilerTime(); }
+
+void EndProfileZone(ProfileZone zone) {
+  zoneAccum[zone] += GetProfilerTime() - zoneStart[zone];
+}
+
+float GetProfileZoneLastMs(ProfileZone zone) {
+  if (historyCount == 0)
+    return 0.0f;
+
+  return history[(historyNext + PROFILE_HISTORY - 1) % PROFILE_HISTORY][zone];
+}
+
+void ToggleProfilerOverlay(void) { overlayVisible = !overlayVisible; }
+
+void DrawProfilerOverlay(void) {
+  if (!overlayVisible || (historyCount == 0))
+    return;
+
+  const int graphHeight = 60;
+  const float graphMaxMs = 33.3f; // Two 60 Hz frames fill the graph
+  int width = PROFILE_HISTORY + 20;
+  int x = GetScreenWidth() - width - 10;
+  int y = 10;
+  int height = 30 + PROFILE_ZONE_COUNT * 12 + graphHeight + 10;
+
+  DrawRectangle(x, y, width, height, Fade(BLACK, 0.75f));
+  DrawText("zone          min    avg    p99 (ms)", x + 10, y + 8, 10, WHITE);
+
+  float sorted[PROFILE_HISTORY];
+  for (int zone = 0; zone < PROFILE_ZONE_COUNT; zone++) {
+    float sum = 0.0f;
+    for (int i = 0; i < historyCount; i++) {
+      sorted[i] = history[i][zone];
+      sum += sorted[i];
+    }
+    qsort(sorted, historyCount, sizeof(float), CompareFloats);
+    int p99 = (historyCount * 99) / 100;
+    if (p99 >= historyCount)
+      p99 = historyCount - 1;
+
+    DrawText(TextFormat("%-12s %6.2f %6.2f %6.2f", zoneNames[zone], sorted[0],
+                        sum / historyCount, sorted[p99]),
+             x + 10, y + 24 + zone * 12, 10,
+             (zone == PROFILE_ZONE_FRAME) ? YELLOW : LIGHTGRAY);
+  }
+
+  // Frame-time graph, oldest frame on the left, with a 60 Hz budget line
+  int graphTop = y + 30 + PROFILE_ZONE_COUNT * 12;
+  int graphBottom = graphTop + graphHeight;
+  for (int i = 0; i < historyCount; i++) {
+    int slot = (historyNext - historyCount + i + PROFILE_HISTORY) %
+               PROFILE_HISTORY;
+    float ms = history[slot][PROFILE_ZONE_FRAME];
+    int barHeight = (int)(graphHeight * ((ms < graphMaxMs) ? ms : graphMaxMs) /
+                          graphMaxMs);
+    DrawLine(x + 10 + i, graphBottom, x + 10 + i, graphBottom - barHeight,
+             (ms > 1000.0f / 60.0f) ? RED : GREEN);
+  }
+  int budgetY = graphBottom - (int)(graphHeight * (1000.0f / 60.0f) /
+                                    graphMaxMs);
+  DrawLine(x + 10, budgetY, x + 10 + PROFILE_HISTORY, budgetY, YELLOW);
+}
+
+bool ExportProfilerCSV(const char *fileName) {
+  FILE *file = fopen(fileName, "w");
+  if (file == NULL) {
+    TraceLog(LOG_WARNING, "PROFILER: [%s] Failed to open for writing",
+             fileName);
+    return false;
+  }
+
+  fprintf(file, "frame");
+  for (int zone = 0; zone < PROFILE_ZONE_COUNT; zone++)
+    fprintf(file, ",%s_ms", zoneNames[zone]);
+  fprintf(file, "\n");
+
+  for (int i = 0; i < historyCount; i++) {
+    int slot = (historyNext - historyCount + i + PROFILE_HISTORY) %
+               PROFILE_HISTORY;
+    fprintf(file, "%d", i);
+    for (int zone = 0; zone < PROFILE_ZONE_COUNT; zone++)
+      fprintf(file, ",%.4f", history[slot][zone]);
+    fprintf(file, "\n");
+  }
+
+  fclose(file);
+  TraceLog(LOG_INFO, "PROFILER: [%s] Exported %d frames", fileName,
+           historyCount);
+  return true;
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+static int CompareFloats(const void *a, const void *b) {
+  float fa = *(const float *)a;
+  float fb = *(const float *)b;
+  return (fa > fb) - (fa < fb);
+}
@@ -0,0 +1,67 @@
+/**********************************************************************************************
+ *
+ *   Profiler - Per-frame phase timings with an in-game overlay
+ *
+ *   Code is timed by wrapping it in BeginProfileZone()/EndProfileZone(); a
+ *   zone entered several times in a frame accumulates. EndProfilerFrame()
+ *   pushes the frame into a ring buffer of PROFILE_HISTORY frames, which the
+ *   overlay summarizes (min/avg/p99 per zone, frame-time graph) and
+ *   ExportProfilerCSV() writes out oldest frame first.
+ *
+ *   The timer is the OS monotonic clock rather than GetTime(), so zones also
+ *   work in the headless runner where no window exists.
+ *
+ **********************************************************************************************/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdbool.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define PROFILE_HISTORY 240 // Frames kept in the ring buffer
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum ProfileZone {
+  PROFILE_ZONE_FRAME = 0, // Time between two BeginProfilerFrame() calls
+  PROFILE_ZONE_INPUT,
+  PROFILE_ZONE_BULLETS,
+  PROFILE_ZONE_ROCKS,
+  PROFILE_ZONE_COLLISIONS,
+  PROFILE_ZONE_SPAWNING,
+  PROFILE_ZONE_DRAW_3D,
+  PROFILE_ZONE_DRAW_HUD,
+  PROFILE_ZONE_PARTICLES, // Particle update, drawing is PROFILE_ZONE_DRAW_FX
+  PROFILE_ZONE_DRAW_FX,
+  PROFILE_ZONE_MUSIC,
+  PROFILE_ZONE_TRANSITION,
+  PROFILE_ZONE_COUNT
+} ProfileZone;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//----------------------------------------------------------------------------------
+// Profiler Functions Declaration
+//----------------------------------------------------------------------------------
+double GetProfilerTime(void); // Monotonic seconds, arbitrary origin
+void BeginProfilerFrame(void);
+void EndProfilerFrame(void);
+void BeginProfileZone(ProfileZone zone);
+void EndProfileZone(ProfileZone zone);
+float GetProfileZoneLastMs(ProfileZone zone); // Last completed frame
+
+void ToggleProfilerOverlay(void);
+void DrawProfilerOverlay(void); // Does nothing while the overlay is hidden
+bool ExportProfilerCSV(const char *fileName);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PROFILER_H
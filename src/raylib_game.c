@@ -13,20 +13,32 @@
  *
  ********************************************************************************************/
 
+#include "asset_cache.h"
+#include "asset_loader.h"
+#include "asset_pack.h"
+#include "frame_arena.h"
+#include "job_system.h"
+#include "music_streamer.h"
+#include "profiler.h"
 #include "raylib.h"
+#include "resource_tracker.h"
 #include "screens.h" // NOTE: Declares global (extern) variables and screens functions
+#include "tagged_heap.h"
 
 #if defined(PLATFORM_WEB)
 #include <emscripten/emscripten.h>
 #endif
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
 //----------------------------------------------------------------------------------
 // Shared Variables Definition (global)
 // NOTE: Those variables are shared between modules through screens.h
 //----------------------------------------------------------------------------------
 GameScreen currentScreen = LOGO;
 Font font = {0};
-Music music = {0};
 Sound fxCoin = {0};
 
 //----------------------------------------------------------------------------------
@@ -42,6 +54,12 @@ static bool transFadeOut = false;
 static int transFromScreen = -1;
 static GameScreen transToScreen = UNKNOWN;
 
+static double startupTime = 0.0; // Cleared once the first frame is logged
+
+// Resource owners, by GameScreen
+static const char *screenNames[] = {"logo", "title", "options", "gameplay",
+                                    "ending"};
+
 //----------------------------------------------------------------------------------
 // Local Functions Declaration
 //----------------------------------------------------------------------------------
@@ -53,29 +71,121 @@ static void UpdateTransition(void);         // Update transition effect
 static void
 DrawTransition(void); // Draw transition effect (full-screen rectangle)
 
+static void PreloadScreen(GameScreen screen); // Queue next screen's assets
+static const char *GetScreenName(int screen); // Owner of its resources
+
 static void UpdateDrawFrame(void); // Update and draw one frame
 
 //----------------------------------------------------------------------------------
 // Main entry point
 //----------------------------------------------------------------------------------
-int main(void) {
+int main(int argc, char **argv) {
   // Initialization
   //---------------------------------------------------------
+  startupTime = GetProfilerTime();
+
+  const char *profileCsvFile = NULL; // Frame timings written here on exit
+  int threads = 1;                   // Entity update threads, main included
+  bool usePack = true;               // Loose files only with --no-pack
+  bool useAssetCache = true;         // Always decode with --no-asset-cache
+  const char *recordFile = NULL;     // Gameplay sessions saved here
+  const char *replayFile = NULL;     // Gameplay played back from here
+  const char *scenarioFile = NULL;   // Gameplay rules loaded from here
+  int targetFps = 60;                // Render rate cap, 0 for uncapped
+  bool vsync = false;                // Render at the display refresh rate
+  // Simulation rate, kept whatever the render rate
+  int tickRate = SIM_DEFAULT_TICK_RATE;
+  bool assertNoAlloc = false; // Heap growth in steady gameplay is fatal
+  bool heapGuards = false;    // Overrun checks around tagged heap blocks
+
+  for (int i = 1; i < argc; i++) {
+    if ((strcmp(argv[i], "--profile-csv") == 0) && (i + 1 < argc))
+      profileCsvFile = argv[++i];
+    else if ((strcmp(argv[i], "--threads") == 0) && (i + 1 < argc))
+      threads = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--no-pack") == 0)
+      usePack = false;
+    else if (strcmp(argv[i], "--no-asset-cache") == 0)
+      useAssetCache = false;
+    else if ((strcmp(argv[i], "--record") == 0) && (i + 1 < argc))
+      recordFile = argv[++i];
+    else if ((strcmp(argv[i], "--replay") == 0) && (i + 1 < argc))
+      replayFile = argv[++i];
+    else if ((strcmp(argv[i], "--scenario") == 0) && (i + 1 < argc))
+      scenarioFile = argv[++i];
+    else if ((strcmp(argv[i], "--fps") == 0) && (i + 1 < argc))
+      targetFps = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--vsync") == 0)
+      vsync = true;
+    else if ((strcmp(argv[i], "--tick-rate") == 0) && (i + 1 < argc))
+      tickRate = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--assert-no-alloc") == 0)
+      assertNoAlloc = true;
+    else if (strcmp(argv[i], "--heap-guards") == 0)
+      heapGuards = true;
+    else {
+      fprintf(stderr,
+              "usage: %s [--profile-csv FILE] [--threads N] [--no-pack] "
+              "[--no-asset-cache] [--record FILE] [--replay FILE] "
+              "[--scenario FILE] [--fps N] [--vsync] [--tick-rate HZ] "
+              "[--assert-no-alloc] [--heap-guards]\n",
+              argv[0]);
+      return 1;
+    }
+  }
+
+  Scenario scenario = {0};
+  if ((scenarioFile != NULL) && !LoadScenario(scenarioFile, &scenario)) {
+    fprintf(stderr, "%s: cannot load scenario\n", scenarioFile);
+    return 1;
+  }
+
+  if (vsync)
+    SetConfigFlags(FLAG_VSYNC_HINT);
   InitWindow(screenWidth, screenHeight, "raylib game template");
 
   InitAudioDevice(); // Initialize audio device
+  SetTaggedHeapGuards(heapGuards); // NOTE: Before anything allocates
+  InitJobSystem(threads);
+  InitFrameArena(FRAME_ARENA_DEFAULT_SIZE);
+  SetFrameHeapAssert(assertNoAlloc);
+  SetAssetCacheEnabled(useAssetCache);
+  InitAssetLoader();
 
   // Load global data (assets that must be available in all screens, i.e. font)
-  font = LoadFont("resources/mecha.png");
-  music = LoadMusicStream("resources/ambient.ogg");
-  fxCoin = LoadSound("resources/coin.wav");
+  double assetsStart = GetProfilerTime();
+  if (usePack)
+    OpenAssetPack("resources.pak");
+  Image fontImage = LoadCachedImage("resources/mecha.png");
+  font = (fontImage.data != NULL)
+             ? TrackFont(LoadFontFromImage(fontImage, MAGENTA, 32),
+                         "resources/mecha.png")
+             : GetFontDefault();
+  UnloadImage(fontImage);
+  InitMusicStreamer("resources/ambient.ogg");
+  fxCoin = TrackSound(LoadPackedSound("resources/coin.wav"),
+                      "resources/coin.wav");
+  TraceLog(LOG_INFO, "STARTUP: Global assets loaded in %.2f ms from %s",
+           (GetProfilerTime() - assetsStart) * 1000.0,
+           IsAssetPackOpen() ? "resources.pak" : "loose files");
 
   SetMasterVolume(0.2f);
-  SetMusicVolume(music, 1.0f);
-  PlayMusicStream(music);
+  SetMusicStreamerVolume(1.0f);
 
-  // Setup and init first screen
+  // Setup and init first screen, straight into gameplay for a replay or a
+  // scenario
+  SetGameplayReplayFiles(recordFile, replayFile);
+  SetGameplayScenario((scenarioFile != NULL) ? &scenario : NULL);
+  SetGameplayTickRate(tickRate);
   currentScreen = TITLE;
+  if ((replayFile != NULL) || (scenarioFile != NULL))
+    currentScreen = GAMEPLAY;
+  SetResourceOwner(GetScreenName(currentScreen));
+  if (currentScreen == GAMEPLAY) {
+    InitGameplayScreen();
+  } else {
+    InitTitleScreen(); // NOTE: Lays out the title text
+  }
   /* InitLogoScreen(); */
   /* ToggleFullscreen(); */
   SetTraceLogLevel(LOG_ALL);
@@ -83,7 +193,9 @@ int main(void) {
 #if defined(PLATFORM_WEB)
   emscripten_set_main_loop(UpdateDrawFrame, 60, 1);
 #else
-  SetTargetFPS(60); // Set our game to run at 60 frames-per-second
+  // Gameplay steps at its own tick rate, so the render rate is free: capped,
+  // uncapped (0) or left to vsync
+  SetTargetFPS(targetFps);
   //--------------------------------------------------------------------------------------
 
   // Main game loop
@@ -95,6 +207,9 @@ int main(void) {
 
   // De-Initialization
   //--------------------------------------------------------------------------------------
+  if (profileCsvFile != NULL)
+    ExportProfilerCSV(profileCsvFile);
+
   // Unload current screen data before closing
   switch (currentScreen) {
   case LOGO:
@@ -113,12 +228,20 @@ int main(void) {
     break;
   }
 
-  // Unload global data loaded
-  UnloadFont(font);
-  UnloadMusicStream(music);
-  UnloadSound(fxCoin);
+  ReportResourceLeaks(GetScreenName(currentScreen));
 
-  CloseAudioDevice(); // Close audio context
+  // Unload global data loaded
+  UnloadFontTracked(font);
+  UnloadMusicStreamer();
+  UnloadSoundTracked(fxCoin);
+  CloseAssetPack(); // NOTE: After the music streamer, which reads from it
+
+  UnloadAssetLoader();
+  UnloadFrameArena();
+  UnloadJobSystem();
+  ReportResourceLeaks(NULL); // NOTE: Everything should be unloaded by now
+  ReportTaggedHeapLeaks();
+  CloseAudioDevice();        // Close audio context
 
   CloseWindow(); // Close window and OpenGL context
   //--------------------------------------------------------------------------------------
@@ -148,8 +271,10 @@ static void ChangeToScreen(GameScreen screen) {
   default:
     break;
   }
+  ReportResourceLeaks(GetScreenName(currentScreen));
 
   // Init next screen
+  SetResourceOwner(GetScreenName(screen));
   switch (screen) {
   case LOGO:
     InitLogoScreen();
@@ -177,11 +302,33 @@ static void TransitionToScreen(GameScreen screen) {
   transFromScreen = currentScreen;
   transToScreen = screen;
   transAlpha = 0.0f;
+
+  // Decode the next screen's assets while this one fades out
+  PreloadScreen(screen);
+}
+
+// Queue the assets a screen needs on the background loader
+static void PreloadScreen(GameScreen screen) {
+  switch (screen) {
+  case GAMEPLAY:
+    PreloadGameplayScreen();
+    break;
+  default:
+    break;
+  }
+}
+
+static const char *GetScreenName(int screen) {
+  if ((screen < LOGO) || (screen > ENDING))
+    return RESOURCE_OWNER_GLOBAL;
+
+  return screenNames[screen];
 }
 
 // Update transition effect (fade-in, fade-out)
 static void UpdateTransition(void) {
   if (!transFadeOut) {
+    UpdateAssetLoader(ASSET_UPLOAD_BUDGET);
     transAlpha += 0.05f;
 
     // NOTE: Due to float internal representation, condition jumps on 1.0f
@@ -190,6 +337,10 @@ static void UpdateTransition(void) {
     if (transAlpha > 1.01f) {
       transAlpha = 1.0f;
 
+      // Hold on the black screen until the next screen's assets are uploaded
+      if (GetPendingAssetCount() > 0)
+        return;
+
       // Unload current screen
       switch (transFromScreen) {
       case LOGO:
@@ -211,7 +362,10 @@ static void UpdateTransition(void) {
         break;
       }
 
+      ReportResourceLeaks(GetScreenName(transFromScreen));
+
       // Load next screen
+      SetResourceOwner(GetScreenName(transToScreen));
       switch (transToScreen) {
       case LOGO:
         InitLogoScreen();
@@ -252,13 +406,21 @@ static void UpdateTransition(void) {
 static void DrawTransition(void) {
   DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(),
                 Fade(BLACK, transAlpha));
+
+  if (!transFadeOut && (transAlpha >= 1.0f) && (GetPendingAssetCount() > 0))
+    DrawText("LOADING...", 20, GetScreenHeight() - 40, 20, RAYWHITE);
 }
 
 // Update and draw game frame
 static void UpdateDrawFrame(void) {
+  BeginProfilerFrame();
+  ResetFrameArena(); // NOTE: Frees last frame's scratch data
+
   // Update
   //----------------------------------------------------------------------------------
-  UpdateMusicStream(music); // NOTE: Music keeps playing between screens
+  BeginProfileZone(PROFILE_ZONE_MUSIC);
+  UpdateMusicStreamer(); // NOTE: Only decodes in the main-thread fallback
+  EndProfileZone(PROFILE_ZONE_MUSIC);
 
   if (!onTransition) {
     switch (currentScreen) {
@@ -303,8 +465,16 @@ static void UpdateDrawFrame(void) {
     default:
       break;
     }
-  } else
+  } else {
+    BeginProfileZone(PROFILE_ZONE_TRANSITION);
     UpdateTransition(); // Update transition (fade-in, fade-out)
+    EndProfileZone(PROFILE_ZONE_TRANSITION);
+  }
+
+  if (IsKeyPressed(KEY_F3))
+    ToggleProfilerOverlay();
+  if (IsKeyPressed(KEY_F4))
+    ToggleResourceOverlay();
   //----------------------------------------------------------------------------------
 
   // Draw
@@ -338,7 +508,18 @@ static void UpdateDrawFrame(void) {
     DrawTransition();
 
   // DrawFPS(10, 10);
+  DrawProfilerOverlay(); // F3
+  DrawResourceOverlay(); // F4
 
   EndDrawing();
   //----------------------------------------------------------------------------------
+
+  EndProfilerFrame();
+  EndTaggedHeapFrame();
+
+  if (startupTime > 0.0) {
+    TraceLog(LOG_INFO, "STARTUP: First frame after %.2f ms",
+             (GetProfilerTime() - startupTime) * 1000.0);
+    startupTime = 0.0;
+  }
 }
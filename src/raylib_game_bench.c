@@ -0,0 +1,288 @@
+/*******************************************************************************************
+ *
+ *   raylib game - gameplay microbenchmarks
+ *
+ *   Times the simulation hot paths on synthetic scenes of 1k, 10k and 100k
+ *   entities without a window or GPU. Every result is printed as one JSON
+ *   object per line so runs can be diffed or collected between commits.
+ *
+ *   Usage: raylib_game_bench [--quick] [--threads N]
+ *
+ ********************************************************************************************/
+
+#include "collision_grid.h"
+#include "entity_kernels.h"
+#include "job_system.h"
+#include "model_cache.h"
+#include "profiler.h"
+#include "raylib.h"
+#include "simulation.h"
+#include "tagged_heap.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define BENCH_DT (1.0f / SIM_DEFAULT_TICK_RATE)
+#define BENCH_FRAMES_PER_SCENE 10
+#define BENCH_VERIFY_SCENES 200
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum BenchKind {
+  BENCH_UPDATE_BULLETS = 0,
+  BENCH_UPDATE_ROCKS,
+  BENCH_COLLISIONS,
+  BENCH_CHURN,
+} BenchKind;
+
+typedef struct BenchResult {
+  long frames;
+  double seconds;
+  long allocs;
+  long entityFrames; // Sum over frames of the entities processed
+} BenchResult;
+
+//----------------------------------------------------------------------------------
+// Local Variables Definition (local to this module)
+//----------------------------------------------------------------------------------
+static const char *benchNames[] = {"update_bullets", "update_rocks",
+                                   "check_entity_collisions",
+                                   "spawn_despawn_churn"};
+static unsigned int benchRng = 12345;
+static double minSecondsPerBench = 0.25;
+
+//----------------------------------------------------------------------------------
+// Local Functions Declaration
+//----------------------------------------------------------------------------------
+static float RandomFloat(float min, float max);
+static void FillScene(Simulation *sim, int numBullets, int numRocks);
+static BenchResult RunBench(BenchKind kind, int entities);
+static unsigned int RunUpdateScene(int entities);
+static bool VerifyParallelUpdate(int entities);
+static bool VerifyEntityKernels(int entities);
+
+//----------------------------------------------------------------------------------
+// Main entry point
+//----------------------------------------------------------------------------------
+int main(int argc, char **argv) {
+  static const int sizes[] = {1000, 10000, 100000};
+  int threads = 1;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--quick") == 0)
+      minSecondsPerBench = 0.02;
+    else if ((strcmp(argv[i], "--threads") == 0) && (i + 1 < argc))
+      threads = (int)strtol(argv[++i], NULL, 10);
+    else {
+      fprintf(stderr, "usage: %s [--quick] [--threads N]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  SetTraceLogLevel(LOG_WARNING);
+  InitJobSystem(threads);
+
+  bool verified = VerifyCollisionGridScenes(BENCH_VERIFY_SCENES, 1);
+  printf("{\"bench\":\"collision_grid_verify\",\"scenes\":%d,\"passed\":%s}\n",
+         BENCH_VERIFY_SCENES, verified ? "true" : "false");
+
+  bool parallelVerified = VerifyParallelUpdate(100000);
+  printf("{\"bench\":\"parallel_update_verify\",\"threads\":%d,"
+         "\"passed\":%s}\n",
+         GetJobThreadCount(), parallelVerified ? "true" : "false");
+  verified = verified && parallelVerified;
+
+  bool kernelVerified = VerifyEntityKernels(100000);
+  printf("{\"bench\":\"entity_kernel_verify\",\"kernel\":\"%s\","
+         "\"passed\":%s}\n",
+         GetEntityKernelName(GetEntityKernel()),
+         kernelVerified ? "true" : "false");
+  verified = verified && kernelVerified;
+
+  // The integration benches run once per compiled kernel, scalar first
+  EntityKernel bestKernel = GetEntityKernel();
+  for (int kind = 0; kind <= BENCH_CHURN; kind++) {
+    bool perKernel = (kind == BENCH_UPDATE_BULLETS) ||
+                     (kind == BENCH_UPDATE_ROCKS);
+    for (EntityKernel kernel = perKernel ? ENTITY_KERNEL_SCALAR : bestKernel;
+         kernel <= bestKernel; kernel++) {
+      SetEntityKernel(kernel);
+      for (int s = 0; s < (int)(sizeof(sizes) / sizeof(sizes[0])); s++) {
+        BenchResult result = RunBench(kind, sizes[s]);
+        printf("{\"bench\":\"%s\",\"entities\":%d,\"threads\":%d,"
+               "\"kernel\":\"%s\",\"frames\":%ld,\"ns_per_frame\":%.1f,"
+               "\"ns_per_entity\":%.3f,\"allocs_per_frame\":%.3f}\n",
+               benchNames[kind], sizes[s], GetJobThreadCount(),
+               GetEntityKernelName(kernel), result.frames,
+               result.seconds * 1e9 / result.frames,
+               result.seconds * 1e9 / result.entityFrames,
+               (double)result.allocs / result.frames);
+        fflush(stdout);
+      }
+    }
+  }
+
+  UnloadJobSystem();
+
+  return verified ? 0 : 1;
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+static float RandomFloat(float min, float max) {
+  benchRng ^= benchRng << 13;
+  benchRng ^= benchRng >> 17;
+  benchRng ^= benchRng << 5;
+  return min + (max - min) * (benchRng / 4294967295.0f);
+}
+
+// Bullets and rocks spread over the play field, none of them expiring within
+// the frames of one scene
+static void FillScene(Simulation *sim, int numBullets, int numRocks) {
+  EntityStore *bullets = &sim->bullets;
+  EntityStore *rocks = &sim->rocks;
+
+  for (int i = 0; i < numBullets; i++) {
+    int bullet = SpawnEntity(bullets);
+    bullets->model[bullet] = AcquireModel(MODEL_KIND_BULLET, 0.0f);
+    bullets->posX[bullet] = RandomFloat(-15.0f, 15.0f);
+    bullets->posY[bullet] = RandomFloat(-6.0f, 6.0f);
+    bullets->dir[bullet] = RandomFloat(-PI, PI);
+    bullets->velX[bullet] = SIM_BULLET_SPEED * cosf(bullets->dir[bullet]);
+    bullets->velY[bullet] = -SIM_BULLET_SPEED * sinf(bullets->dir[bullet]);
+  }
+
+  for (int i = 0; i < numRocks; i++) {
+    float radius = (int)RandomFloat(0.0f, 10.99f) / 8.0f + 2.5f;
+    int rock = SpawnEntity(rocks);
+    rocks->model[rock] = AcquireModel(MODEL_KIND_ROCK, radius);
+    rocks->radius[rock] = radius;
+    rocks->posX[rock] = RandomFloat(-22.0f, 22.0f);
+    rocks->posY[rock] = RandomFloat(-12.0f, 12.0f);
+    rocks->dir[rock] = RandomFloat(-PI, PI);
+    rocks->velX[rock] = SIM_ROCK_SPEED * cosf(rocks->dir[rock]);
+    rocks->velY[rock] = SIM_ROCK_SPEED * sinf(rocks->dir[rock]);
+    rocks->lifeTime[rock] = 1e9f;
+  }
+}
+
+static BenchResult RunBench(BenchKind kind, int entities) {
+  BenchResult result = {0};
+  int numRocks = (kind == BENCH_COLLISIONS) ? entities / 10 : entities;
+  int numBullets = entities;
+
+  while (result.seconds < minSecondsPerBench) {
+    // Untimed scene setup, fresh every BENCH_FRAMES_PER_SCENE frames so
+    // bullets never drift out of the play field
+    Simulation sim = {0};
+    InitSimulation(&sim, 1);
+    FillScene(&sim, (kind == BENCH_UPDATE_ROCKS) ? 0 : numBullets,
+              (kind == BENCH_UPDATE_BULLETS) ? 0 : numRocks);
+    EntityStore *churnStore = &sim.bullets;
+
+    // Every tagged heap allocation, not only entity store growth
+    int allocsBefore = GetTaggedHeapTotals().allocs;
+    double start = GetProfilerTime();
+    for (int frame = 0; frame < BENCH_FRAMES_PER_SCENE; frame++) {
+      switch (kind) {
+      case BENCH_UPDATE_BULLETS:
+        UpdateBullets(&sim, BENCH_DT);
+        result.entityFrames += sim.bullets.count;
+        break;
+      case BENCH_UPDATE_ROCKS:
+        UpdateRocks(&sim, BENCH_DT);
+        result.entityFrames += sim.rocks.count;
+        break;
+      case BENCH_COLLISIONS:
+        CheckEntityCollisions(&sim);
+        result.entityFrames += sim.bullets.count + sim.rocks.count;
+        // Hits are only flagged here, clear them so every frame tests the
+        // same scene
+        memset(sim.bullets.flags, 0, sim.bullets.count);
+        memset(sim.rocks.flags, 0, sim.rocks.count);
+        break;
+      case BENCH_CHURN: {
+        // Replace a tenth of the bullets every frame
+        int churn = churnStore->count / 10;
+        for (int i = 0; i < churn; i++) {
+          int victim = (i * 7919) % churnStore->count;
+          if (churnStore->flags[victim] & ENTITY_FLAG_DEAD)
+            continue;
+          ReleaseModel(churnStore->model[victim]);
+          DespawnEntity(churnStore, victim);
+        }
+        CompactEntityStore(churnStore);
+        for (int i = 0; i < churn; i++) {
+          int bullet = SpawnEntity(churnStore);
+          churnStore->model[bullet] = AcquireModel(MODEL_KIND_BULLET, 0.0f);
+          churnStore->velX[bullet] = SIM_BULLET_SPEED;
+        }
+        result.entityFrames += churn;
+      } break;
+      default:
+        break;
+      }
+    }
+    result.seconds += GetProfilerTime() - start;
+    result.allocs += GetTaggedHeapTotals().allocs - allocsBefore;
+    result.frames += BENCH_FRAMES_PER_SCENE;
+
+    UnloadSimulation(&sim);
+  }
+
+  if (result.entityFrames == 0)
+    result.entityFrames = 1;
+  return result;
+}
+
+// Checksum after a second of updates on a fixed scene, with short rock
+// lifetimes so removals happen as well
+static unsigned int RunUpdateScene(int entities) {
+  Simulation sim = {0};
+  unsigned int rngBefore = benchRng;
+
+  InitSimulation(&sim, 1);
+  FillScene(&sim, entities, entities);
+  for (int i = 0; i < sim.rocks.count; i++)
+    sim.rocks.lifeTime[i] = RandomFloat(0.0f, 0.5f);
+  benchRng = rngBefore;
+
+  for (int frame = 0; frame < 60; frame++) {
+    UpdateBullets(&sim, BENCH_DT);
+    UpdateRocks(&sim, BENCH_DT);
+  }
+  unsigned int checksum = GetSimulationChecksum(&sim);
+  UnloadSimulation(&sim);
+
+  return checksum;
+}
+
+// Same scene updated on the job system and then serially
+static bool VerifyParallelUpdate(int entities) {
+  int threads = GetJobThreadCount();
+  unsigned int parallel = RunUpdateScene(entities);
+
+  UnloadJobSystem();
+  unsigned int serial = RunUpdateScene(entities);
+  InitJobSystem(threads);
+
+  return parallel == serial;
+}
+
+// Same scene updated with the selected kernel and then the scalar one
+static bool VerifyEntityKernels(int entities) {
+  EntityKernel kernel = GetEntityKernel();
+  unsigned int vectorized = RunUpdateScene(entities);
+
+  SetEntityKernel(ENTITY_KERNEL_SCALAR);
+  unsigned int scalar = RunUpdateScene(entities);
+  SetEntityKernel(kernel);
+
+  return vectorized == scalar;
+}
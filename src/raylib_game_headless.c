@@ -0,0 +1,241 @@
+/*******************************************************************************************
+ *
+ *   raylib game - headless simulation runner
+ *
+ *   Runs the gameplay simulation for a fixed number of fixed-timestep ticks,
+ *   as fast as possible, without opening a window or touching the GPU.
+ *   Prints the tick throughput and a checksum of the final world state, so
+ *   two runs with the same arguments must print the same checksum.
+ *
+ *   --scenario replaces the game's spawn and fire rules with a workload from
+ *   a scenario file; its duration sets the tick count unless --ticks is
+ *   given.
+ *
+ *   --record writes the run to a replay file; --replay plays one back
+ *   instead of the autopilot, recorded in game or here, and fails unless the
+ *   final checksum matches the recorded one.
+ *
+ *   --heap-report prints the tagged heap statistics of every subsystem and
+ *   which ticks still allocated, and fails if anything is left allocated
+ *   after the simulation is unloaded. --heap-guards puts guard bytes around
+ *   every block, checks them after each tick and fails on an overrun. Both
+ *   are meant for memory regression runs.
+ *
+ *   Usage: raylib_game_headless [--ticks N] [--seed N] [--tick-rate HZ]
+ *                               [--threads N] [--scenario FILE]
+ *                               [--record FILE] [--replay FILE]
+ *                               [--heap-report] [--heap-guards]
+ *
+ ********************************************************************************************/
+
+#include "frame_arena.h"
+#include "job_system.h"
+#include "profiler.h"
+#include "raylib.h"
+#include "replay.h"
+#include "scenario.h"
+#include "simulation.h"
+#include "tagged_heap.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Local Functions Declaration
+//----------------------------------------------------------------------------------
+static SimInput GetAutopilotInput(const Simulation *sim, float dt);
+static void PrintHeapReport(void);
+
+//----------------------------------------------------------------------------------
+// Main entry point
+//----------------------------------------------------------------------------------
+int main(int argc, char **argv) {
+  long ticks = 0; // Scenario duration if set, else ten minutes at 60 Hz
+  unsigned int seed = 1;
+  int tickRate = SIM_DEFAULT_TICK_RATE;
+  int threads = 1;
+  const char *scenarioFile = NULL;
+  const char *recordFile = NULL;
+  const char *replayFile = NULL;
+  bool heapReport = false;
+  bool heapGuards = false;
+
+  for (int i = 1; i < argc; i++) {
+    if ((strcmp(argv[i], "--ticks") == 0) && (i + 1 < argc))
+      ticks = strtol(argv[++i], NULL, 10);
+    else if ((strcmp(argv[i], "--seed") == 0) && (i + 1 < argc))
+      seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+    else if ((strcmp(argv[i], "--tick-rate") == 0) && (i + 1 < argc))
+      tickRate = (int)strtol(argv[++i], NULL, 10);
+    else if ((strcmp(argv[i], "--threads") == 0) && (i + 1 < argc))
+      threads = (int)strtol(argv[++i], NULL, 10);
+    else if ((strcmp(argv[i], "--scenario") == 0) && (i + 1 < argc))
+      scenarioFile = argv[++i];
+    else if ((strcmp(argv[i], "--record") == 0) && (i + 1 < argc))
+      recordFile = argv[++i];
+    else if ((strcmp(argv[i], "--replay") == 0) && (i + 1 < argc))
+      replayFile = argv[++i];
+    else if (strcmp(argv[i], "--heap-report") == 0)
+      heapReport = true;
+    else if (strcmp(argv[i], "--heap-guards") == 0)
+      heapGuards = true;
+    else {
+      fprintf(stderr,
+              "usage: %s [--ticks N] [--seed N] [--tick-rate HZ] "
+              "[--threads N] [--scenario FILE] [--record FILE] "
+              "[--replay FILE] [--heap-report] [--heap-guards]\n",
+              argv[0]);
+      return 1;
+    }
+  }
+
+  SetTraceLogLevel(LOG_WARNING);
+  SetTaggedHeapGuards(heapGuards);
+
+  Scenario scenario = GetDefaultScenario();
+  if ((scenarioFile != NULL) && !LoadScenario(scenarioFile, &scenario)) {
+    fprintf(stderr, "%s: cannot load scenario\n", scenarioFile);
+    return 1;
+  }
+  if (ticks == 0)
+    ticks = (scenario.duration > 0.0f)
+                ? (long)(scenario.duration * tickRate + 0.5f)
+                : 10L * 60 * SIM_DEFAULT_TICK_RATE;
+  if ((ticks <= 0) || (tickRate <= 0)) {
+    fprintf(stderr, "ticks and tick rate must be positive\n");
+    return 1;
+  }
+
+  Replay replay = {0};
+  if ((replayFile != NULL) && !LoadReplay(&replay, replayFile)) {
+    fprintf(stderr, "%s: cannot load replay\n", replayFile);
+    return 1;
+  }
+  if (replayFile != NULL) {
+    seed = replay.seed;
+    ticks = (long)replay.tickCount;
+    scenario.rules = replay.rules;
+    strcpy(scenario.name, "replay");
+  }
+
+  InitJobSystem(threads);
+  InitFrameArena(FRAME_ARENA_DEFAULT_SIZE);
+
+  Simulation sim = {0};
+  float dt = 1.0f / tickRate;
+  InitSimulationWithRules(&sim, seed, scenario.rules);
+  if (recordFile != NULL)
+    BeginReplayRecording(&replay, seed, scenario.rules);
+
+  int peakBullets = 0;
+  int peakRocks = 0;
+  long allocTicks = 0; // Ticks that touched the tagged heap
+  long lastAllocTick = -1;
+  long firstDamagedTick = -1;
+  EndTaggedHeapFrame(); // NOTE: Setup allocations are not counted as churn
+  double start = GetProfilerTime();
+  for (long tick = 0; tick < ticks; tick++) {
+    ResetFrameArena(); // NOTE: Frees last tick's scratch data
+    SimInput input = {0};
+    if (replayFile != NULL) {
+      if (!ReadReplayTick(&replay, &input, &dt))
+        break;
+    } else {
+      input = GetAutopilotInput(&sim, dt);
+      if (recordFile != NULL)
+        RecordReplayTick(&replay, input, dt);
+    }
+    StepSimulation(&sim, input, dt);
+
+    if (sim.bullets.count > peakBullets)
+      peakBullets = sim.bullets.count;
+    if (sim.rocks.count > peakRocks)
+      peakRocks = sim.rocks.count;
+
+    EndTaggedHeapFrame();
+    MemTagStats churn = GetTaggedHeapTotals();
+    if ((churn.frameAllocs > 0) || (churn.frameFrees > 0)) {
+      allocTicks++;
+      lastAllocTick = tick;
+    }
+    if (heapGuards && (firstDamagedTick < 0) && (CheckTaggedHeapGuards() > 0))
+      firstDamagedTick = tick;
+  }
+  double elapsed = GetProfilerTime() - start;
+
+  printf("scenario=%s ticks=%ld tick_rate=%d seed=%u threads=%d "
+         "seconds=%.6f ticks_per_second=%.1f bullets=%d rocks=%d "
+         "peak_bullets=%d peak_rocks=%d checksum=0x%08x\n",
+         scenario.name, ticks, tickRate, seed, GetJobThreadCount(), elapsed,
+         (elapsed > 0.0) ? ticks / elapsed : 0.0, sim.bullets.count,
+         sim.rocks.count, peakBullets, peakRocks,
+         GetSimulationChecksum(&sim));
+
+  int result = 0;
+  if (replayFile != NULL) {
+    bool match = (GetSimulationChecksum(&sim) == replay.checksum);
+    printf("replay=%s recorded_checksum=0x%08x\n",
+           match ? "match" : "MISMATCH", replay.checksum);
+    if (!match)
+      result = 1;
+  } else if (recordFile != NULL) {
+    EndReplayRecording(&replay, &sim);
+    if (!SaveReplay(&replay, recordFile)) {
+      fprintf(stderr, "%s: cannot save replay\n", recordFile);
+      result = 1;
+    }
+  }
+
+  if (heapReport)
+    PrintHeapReport();
+
+  UnloadReplay(&replay);
+  UnloadSimulation(&sim);
+  UnloadJobSystem();
+  UnloadFrameArena();
+
+  if (heapReport || heapGuards) {
+    MemTagStats heap = GetTaggedHeapTotals();
+    printf("heap_peak_bytes=%zu heap_allocs=%d alloc_ticks=%ld "
+           "last_alloc_tick=%ld leaked_blocks=%d leaked_bytes=%zu "
+           "corruptions=%d first_damaged_tick=%ld\n",
+           heap.peakBytes, heap.allocs, allocTicks, lastAllocTick,
+           heap.liveBlocks, heap.liveBytes, heap.corruptions,
+           firstDamagedTick);
+    if ((heapReport && (heap.liveBlocks > 0)) || (heap.corruptions > 0))
+      result = 1;
+  }
+
+  return result;
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+// Keep firing while sweeping the aim point around the player once every
+// 2*PI seconds of game time
+static SimInput GetAutopilotInput(const Simulation *sim, float dt) {
+  float angle = sim->tick * dt;
+  SimInput input = {
+      .aim = (Vector2){sim->player.pos.x + 10.0f * cosf(angle),
+                       sim->player.pos.y + 10.0f * sinf(angle)},
+      .fire = true,
+  };
+
+  return input;
+}
+
+// One line per subsystem that used the heap, at the end of the run
+static void PrintHeapReport(void) {
+  for (int tag = 0; tag < MEM_TAG_COUNT; tag++) {
+    MemTagStats stats = GetMemTagStats(tag);
+    if (stats.allocs == 0)
+      continue;
+
+    printf("heap tag=%s live_bytes=%zu peak_bytes=%zu live_blocks=%d "
+           "allocs=%d frees=%d corruptions=%d\n",
+           GetMemTagName(tag), stats.liveBytes, stats.peakBytes,
+           stats.liveBlocks, stats.allocs, stats.frees, stats.corruptions);
+  }
+}
@@ -0,0 +1,176 @@
+/*******************************************************************************************
+ *
+ *   raylib game - asset packer
+ *
+ *   Writes the given files into one asset pack, see asset_pack.h for the
+ *   format. Files are stored under the path given on the command line, minus
+ *   any leading "./", which is the name the game loads them by.
+ *
+ *   Usage: raylib_game_packer OUTPUT.pak FILE...
+ *
+ ********************************************************************************************/
+
+#include "asset_pack.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct PackInput {
+  const char *name;
+  unsigned char *data;
+  unsigned int size;
+} PackInput;
+
+//----------------------------------------------------------------------------------
+// Local Functions Declaration
+//----------------------------------------------------------------------------------
+static bool ReadWholeFile(const char *fileName, PackInput *input);
+static unsigned int AlignOffset(unsigned int offset);
+static bool WritePadding(FILE *file, unsigned int from, unsigned int to);
+
+//----------------------------------------------------------------------------------
+// Main entry point
+//----------------------------------------------------------------------------------
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    fprintf(stderr, "usage: %s OUTPUT.pak FILE...\n", argv[0]);
+    return 1;
+  }
+
+  int count = argc - 2;
+  PackInput *inputs = calloc(count, sizeof(PackInput));
+  AssetPackEntry *entries = calloc(count, sizeof(AssetPackEntry));
+
+  // Enough buckets for a load factor of at most one half
+  unsigned int bucketCount = 1;
+  while (bucketCount < 2u * count)
+    bucketCount *= 2;
+  unsigned int *buckets = malloc(sizeof(unsigned int) * bucketCount);
+  for (unsigned int i = 0; i < bucketCount; i++)
+    buckets[i] = ASSET_PACK_NONE;
+
+  for (int i = 0; i < count; i++) {
+    if (!ReadWholeFile(argv[i + 2], &inputs[i]))
+      return 1;
+    inputs[i].name = NormalizeAssetName(argv[i + 2]);
+    for (int j = 0; j < i; j++) {
+      if (strcmp(inputs[j].name, inputs[i].name) == 0) {
+        fprintf(stderr, "%s: listed twice\n", inputs[i].name);
+        return 1;
+      }
+    }
+  }
+
+  // Lay out tables, names, then data, and chain every entry in front of its
+  // bucket so chains always point to lower indices
+  unsigned int offset = sizeof(AssetPackHeader) +
+                        sizeof(unsigned int) * bucketCount +
+                        sizeof(AssetPackEntry) * count;
+  for (int i = 0; i < count; i++) {
+    AssetPackEntry *entry = &entries[i];
+    entry->nameHash = HashAssetName(inputs[i].name);
+    entry->nameOffset = offset;
+    offset += (unsigned int)strlen(inputs[i].name) + 1;
+
+    unsigned int bucket = entry->nameHash & (bucketCount - 1);
+    entry->nextEntry = buckets[bucket];
+    buckets[bucket] = (unsigned int)i;
+  }
+  for (int i = 0; i < count; i++) {
+    offset = AlignOffset(offset);
+    entries[i].dataOffset = offset;
+    entries[i].dataSize = inputs[i].size;
+    offset += inputs[i].size + 1; // Trailing NUL
+  }
+
+  FILE *file = fopen(argv[1], "wb");
+  if (file == NULL) {
+    fprintf(stderr, "%s: cannot open for writing\n", argv[1]);
+    return 1;
+  }
+
+  AssetPackHeader header = {0};
+  memcpy(header.magic, ASSET_PACK_MAGIC, 4);
+  header.version = ASSET_PACK_VERSION;
+  header.entryCount = (unsigned int)count;
+  header.bucketCount = bucketCount;
+
+  bool written =
+      (fwrite(&header, sizeof(header), 1, file) == 1) &&
+      (fwrite(buckets, sizeof(unsigned int), bucketCount, file) ==
+       bucketCount) &&
+      (fwrite(entries, sizeof(AssetPackEntry), count, file) == (size_t)count);
+  for (int i = 0; written && (i < count); i++)
+    written = fwrite(inputs[i].name, strlen(inputs[i].name) + 1, 1, file) == 1;
+
+  unsigned int position = (unsigned int)ftell(file);
+  for (int i = 0; written && (i < count); i++) {
+    written = WritePadding(file, position, entries[i].dataOffset) &&
+              ((inputs[i].size == 0) ||
+               (fwrite(inputs[i].data, inputs[i].size, 1, file) == 1)) &&
+              (fputc('\0', file) != EOF);
+    position = entries[i].dataOffset + inputs[i].size + 1;
+  }
+
+  if (fclose(file) != 0)
+    written = false;
+  if (!written) {
+    fprintf(stderr, "%s: write failed\n", argv[1]);
+    remove(argv[1]);
+    return 1;
+  }
+
+  for (int i = 0; i < count; i++)
+    printf("%10u  %s\n", inputs[i].size, inputs[i].name);
+  printf("%10u  %s (%d files, %u buckets)\n", position, argv[1], count,
+         bucketCount);
+
+  for (int i = 0; i < count; i++)
+    free(inputs[i].data);
+  free(inputs);
+  free(entries);
+  free(buckets);
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+static bool ReadWholeFile(const char *fileName, PackInput *input) {
+  FILE *file = fopen(fileName, "rb");
+  if (file == NULL) {
+    fprintf(stderr, "%s: cannot open\n", fileName);
+    return false;
+  }
+
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+
+  input->size = (size > 0) ? (unsigned int)size : 0;
+  input->data = malloc(input->size + 1);
+  bool read = (input->size == 0) ||
+              (fread(input->data, input->size, 1, file) == 1);
+  fclose(file);
+
+  if (!read)
+    fprintf(stderr, "%s: read failed\n", fileName);
+  return read;
+}
+
+static unsigned int AlignOffset(unsigned int offset) {
+  return (offset + ASSET_PACK_ALIGNMENT - 1) & ~(ASSET_PACK_ALIGNMENT - 1u);
+}
+
+static bool WritePadding(FILE *file, unsigned int from, unsigned int to) {
+  for (; from < to; from++) {
+    if (fputc('\0', file) == EOF)
+      return false;
+  }
+
+  return true;
+}
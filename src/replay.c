@@ -0,0 +1,214 @@
+/**********************************************************************************************
+ *
+ *   Replay - Recorded simulation input, played back tick for tick
+ *
+ *   See replay.h for the tick encoding.
+ *
+ **********************************************************************************************/
+
+#include "replay.h"
+#include "tagged_heap.h"
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define REPLAY_MAX_TICK_SIZE (2 + 3 * sizeof(float))
+#define REPLAY_MIN_CAPACITY 4096
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static void ResetCodec(Replay *replay);
+static unsigned char EncodeMove(Vector2 move);
+static Vector2 DecodeMove(unsigned char move);
+
+//----------------------------------------------------------------------------------
+// Replay Functions Definition
+//----------------------------------------------------------------------------------
+
+void BeginReplayRecording(Replay *replay, unsigned int seed, SimRules rules) {
+  UnloadReplay(replay);
+  replay->seed = seed;
+  replay->rules = rules;
+}
+
+void RecordReplayTick(Replay *replay, SimInput input, float dt) {
+  if (replay->dataSize + (int)REPLAY_MAX_TICK_SIZE > replay->capacity) {
+    int capacity = (replay->capacity > 0) ? replay->capacity * 2
+                                          : REPLAY_MIN_CAPACITY;
+    replay->data = TaggedRealloc(MEM_TAG_REPLAY, replay->data, capacity);
+    replay->capacity = capacity;
+  }
+
+  unsigned char *next = replay->data + replay->dataSize;
+  unsigned char *flags = next++;
+  *flags = input.fire ? REPLAY_TICK_FIRE : 0;
+
+  // Compared bitwise, playback has to hand back the exact same floats
+  unsigned char move = EncodeMove(input.move);
+  if ((replay->cursorTick == 0) ||
+      (move != EncodeMove(replay->lastInput.move))) {
+    *flags |= REPLAY_TICK_MOVE;
+    *next++ = move;
+  }
+  if ((replay->cursorTick == 0) ||
+      (memcmp(&input.aim, &replay->lastInput.aim, sizeof(Vector2)) != 0)) {
+    *flags |= REPLAY_TICK_AIM;
+    memcpy(next, &input.aim, sizeof(Vector2));
+    next += sizeof(Vector2);
+  }
+  if ((replay->cursorTick == 0) ||
+      (memcmp(&dt, &replay->lastDt, sizeof(float)) != 0)) {
+    *flags |= REPLAY_TICK_DT;
+    memcpy(next, &dt, sizeof(float));
+    next += sizeof(float);
+  }
+
+  replay->dataSize = (int)(next - replay->data);
+  replay->cursor = replay->dataSize;
+  replay->cursorTick++;
+  replay->tickCount = replay->cursorTick;
+  replay->lastInput = input;
+  replay->lastDt = dt;
+}
+
+void EndReplayRecording(Replay *replay, const Simulation *sim) {
+  replay->checksum = GetSimulationChecksum(sim);
+  RewindReplay(replay);
+}
+
+bool SaveReplay(const Replay *replay, const char *fileName) {
+  int fileSize = (int)sizeof(ReplayHeader) + replay->dataSize;
+  unsigned char *fileData = TaggedAlloc(MEM_TAG_REPLAY, fileSize);
+
+  ReplayHeader header = {0};
+  memcpy(header.magic, REPLAY_MAGIC, 4);
+  header.version = REPLAY_VERSION;
+  header.seed = replay->seed;
+  header.tickCount = replay->tickCount;
+  header.checksum = replay->checksum;
+  header.dataSize = (unsigned int)replay->dataSize;
+  header.rules = replay->rules;
+  memcpy(fileData, &header, sizeof(header));
+  if (replay->dataSize > 0)
+    memcpy(fileData + sizeof(header), replay->data, replay->dataSize);
+
+  bool saved = SaveFileData(fileName, fileData, fileSize);
+  TaggedFree(fileData);
+
+  if (saved)
+    TraceLog(LOG_INFO, "REPLAY: [%s] Saved %u ticks (%d bytes)", fileName,
+             replay->tickCount, fileSize);
+  return saved;
+}
+
+bool LoadReplay(Replay *replay, const char *fileName) {
+  UnloadReplay(replay);
+
+  int fileSize = 0;
+  unsigned char *fileData = LoadFileData(fileName, &fileSize);
+  if (fileData == NULL)
+    return false;
+
+  ReplayHeader header = {0};
+  if (fileSize >= (int)sizeof(header))
+    memcpy(&header, fileData, sizeof(header));
+  if ((fileSize < (int)sizeof(header)) ||
+      (memcmp(header.magic, REPLAY_MAGIC, 4) != 0) ||
+      (header.version != REPLAY_VERSION) ||
+      (header.dataSize != (unsigned int)fileSize - sizeof(header))) {
+    TraceLog(LOG_WARNING, "REPLAY: [%s] Not a valid replay file", fileName);
+    UnloadFileData(fileData);
+    return false;
+  }
+
+  replay->seed = header.seed;
+  replay->tickCount = header.tickCount;
+  replay->checksum = header.checksum;
+  replay->rules = header.rules;
+  replay->dataSize = (int)header.dataSize;
+  replay->capacity = replay->dataSize;
+  replay->data = TaggedAlloc(MEM_TAG_REPLAY, replay->dataSize + 1);
+  memcpy(replay->data, fileData + sizeof(header), replay->dataSize);
+  UnloadFileData(fileData);
+
+  TraceLog(LOG_INFO, "REPLAY: [%s] Loaded %u ticks, seed %u", fileName,
+           replay->tickCount, replay->seed);
+  return true;
+}
+
+void UnloadReplay(Replay *replay) {
+  TaggedFree(replay->data);
+  *replay = (Replay){0};
+}
+
+void RewindReplay(Replay *replay) { ResetCodec(replay); }
+
+bool ReadReplayTick(Replay *replay, SimInput *input, float *dt) {
+  if (IsReplayFinished(replay))
+    return false;
+
+  const unsigned char *next = replay->data + replay->cursor;
+  const unsigned char *end = replay->data + replay->dataSize;
+  unsigned char flags = *next++;
+
+  int needed = ((flags & REPLAY_TICK_MOVE) ? 1 : 0) +
+               ((flags & REPLAY_TICK_AIM) ? (int)sizeof(Vector2) : 0) +
+               ((flags & REPLAY_TICK_DT) ? (int)sizeof(float) : 0);
+  if (end - next < needed) {
+    TraceLog(LOG_WARNING, "REPLAY: Truncated at tick %u of %u",
+             replay->cursorTick, replay->tickCount);
+    replay->cursor = replay->dataSize;
+    replay->cursorTick = replay->tickCount;
+    return false;
+  }
+
+  if (flags & REPLAY_TICK_MOVE)
+    replay->lastInput.move = DecodeMove(*next++);
+  if (flags & REPLAY_TICK_AIM) {
+    memcpy(&replay->lastInput.aim, next, sizeof(Vector2));
+    next += sizeof(Vector2);
+  }
+  if (flags & REPLAY_TICK_DT) {
+    memcpy(&replay->lastDt, next, sizeof(float));
+    next += sizeof(float);
+  }
+  replay->lastInput.fire = (flags & REPLAY_TICK_FIRE) != 0;
+
+  replay->cursor = (int)(next - replay->data);
+  replay->cursorTick++;
+  *input = replay->lastInput;
+  *dt = replay->lastDt;
+
+  return true;
+}
+
+bool IsReplayFinished(const Replay *replay) {
+  return (replay->cursorTick >= replay->tickCount) ||
+         (replay->cursor >= replay->dataSize);
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+static void ResetCodec(Replay *replay) {
+  replay->cursor = 0;
+  replay->cursorTick = 0;
+  replay->lastInput = (SimInput){0};
+  replay->lastDt = 0.0f;
+}
+
+// Move axes are -1, 0 or 1, two bits each
+static unsigned char EncodeMove(Vector2 move) {
+  int x = (move.x > 0.0f) - (move.x < 0.0f);
+  int y = (move.y > 0.0f) - (move.y < 0.0f);
+
+  return (unsigned char)((x + 1) | ((y + 1) << 2));
+}
+
+static Vector2 DecodeMove(unsigned char move) {
+  return (Vector2){(float)((move & 0x3) - 1),
+                   (float)(((move >> 2) & 0x3) - 1)};
+}
@@ -0,0 +1,94 @@
+/**********************************************************************************************
+ *
+ *   Replay - Recorded simulation input, played back tick for tick
+ *
+ *   The simulation is a pure function of its seed, its rules and the SimInput
+ *   and dt of every tick, so a replay stores exactly that and nothing else.
+ *   Playing it back from InitSimulationWithRules(replay.seed, replay.rules)
+ *   reproduces the recorded world bit for bit, at whatever speed the caller
+ *   steps it; the checksum taken when recording ended tells whether it did.
+ *
+ *   Ticks are delta-encoded against the previous one, one flags byte plus
+ *   only the fields that changed:
+ *
+ *       unsigned char flags    REPLAY_TICK_* bits
+ *       unsigned char move     (x + 1) | (y + 1) << 2, if MOVE
+ *       float aim[2]           if AIM
+ *       float dt               if DT
+ *
+ *   Holding still at a steady frame rate costs one byte per tick. Files are a
+ *   ReplayHeader followed by the tick records, in native byte order.
+ *
+ **********************************************************************************************/
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "raylib.h"
+#include "simulation.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define REPLAY_MAGIC "RPLY"
+#define REPLAY_VERSION 3
+
+#define REPLAY_TICK_FIRE 0x1 // Fire held this tick
+#define REPLAY_TICK_MOVE 0x2 // Move changed
+#define REPLAY_TICK_AIM 0x4  // Aim changed
+#define REPLAY_TICK_DT 0x8   // dt changed
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct ReplayHeader {
+  char magic[4];
+  unsigned int version;
+  unsigned int seed;
+  unsigned int tickCount;
+  unsigned int checksum; // GetSimulationChecksum() after the last tick
+  unsigned int dataSize; // Bytes of tick records that follow
+  SimRules rules;
+} ReplayHeader;
+
+typedef struct Replay {
+  unsigned int seed;
+  unsigned int tickCount;
+  unsigned int checksum;
+  SimRules rules;
+  unsigned char *data; // Tick records
+  int dataSize;
+  int capacity;
+
+  // Codec state, shared by recording and playback
+  int cursor;
+  unsigned int cursorTick;
+  SimInput lastInput;
+  float lastDt;
+} Replay;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//----------------------------------------------------------------------------------
+// Replay Functions Declaration
+//----------------------------------------------------------------------------------
+void BeginReplayRecording(Replay *replay, unsigned int seed, SimRules rules);
+void RecordReplayTick(Replay *replay, SimInput input, float dt);
+void EndReplayRecording(Replay *replay, const Simulation *sim);
+
+bool SaveReplay(const Replay *replay, const char *fileName);
+bool LoadReplay(Replay *replay, const char *fileName); // Rewound on success
+void UnloadReplay(Replay *replay);
+
+void RewindReplay(Replay *replay);
+bool ReadReplayTick(Replay *replay, SimInput *input,
+                    float *dt); // false past the last tick
+bool IsReplayFinished(const Replay *replay);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // REPLAY_H
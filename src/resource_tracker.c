@@ -0,0 +1,278 @@
+/**********************************************************************************************
+ *
+ *   Resource Tracker - Live textures, models, shaders, fonts and sounds
+ *
+ *   See resource_tracker.h for what is tracked and how it is sized.
+ *
+ **********************************************************************************************/
+
+#include "resource_tracker.h"
+#include "raylib.h"
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct TrackedResource {
+  bool live;
+  ResourceKind kind;
+  size_t key;
+  size_t bytes;
+  const char *owner;
+  char name[RESOURCE_NAME_LENGTH];
+} TrackedResource;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static const char *kindNames[RESOURCE_KIND_COUNT] = {
+    "texture", "model", "shader", "font", "sound",
+};
+
+static TrackedResource resources[MAX_TRACKED_RESOURCES] = {0};
+static const char *currentOwner = RESOURCE_OWNER_GLOBAL;
+static size_t peakGpuBytes = 0;
+static int untracked = 0;
+static bool overlayVisible = false;
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static TrackedResource *FindResource(ResourceKind kind, size_t key);
+static size_t GetTextureBytes(Texture2D texture);
+static size_t GetMeshBytes(Mesh mesh);
+static size_t GetGpuBytes(void);
+
+//----------------------------------------------------------------------------------
+// Resource Tracker Functions Definition
+//----------------------------------------------------------------------------------
+
+void SetResourceOwner(const char *owner) {
+  currentOwner = (owner != NULL) ? owner : RESOURCE_OWNER_GLOBAL;
+}
+
+const char *GetResourceOwner(void) { return currentOwner; }
+
+void TrackResource(ResourceKind kind, size_t key, size_t bytes,
+                   const char *name) {
+  if (key == 0)
+    return; // Failed load, nothing to unload later
+
+  TrackedResource *resource = FindResource(kind, key);
+  for (int i = 0; (i < MAX_TRACKED_RESOURCES) && (resource == NULL); i++) {
+    if (!resources[i].live)
+      resource = &resources[i];
+  }
+  if (resource == NULL) {
+    untracked++;
+    TraceLog(LOG_WARNING, "RESOURCES: Table full, %s '%s' not tracked",
+             kindNames[kind], name);
+    return;
+  }
+
+  *resource = (TrackedResource){
+      .live = true,
+      .kind = kind,
+      .key = key,
+      .bytes = bytes,
+      .owner = currentOwner,
+  };
+  strncpy(resource->name, (name != NULL) ? name : "?",
+          RESOURCE_NAME_LENGTH - 1);
+
+  size_t gpuBytes = GetGpuBytes();
+  if (gpuBytes > peakGpuBytes)
+    peakGpuBytes = gpuBytes;
+}
+
+void UntrackResource(ResourceKind kind, size_t key) {
+  TrackedResource *resource = FindResource(kind, key);
+  if (resource != NULL)
+    resource->live = false;
+}
+
+Texture2D TrackTexture(Texture2D texture, const char *name) {
+  TrackResource(RESOURCE_TEXTURE, texture.id, GetTextureBytes(texture), name);
+  return texture;
+}
+
+Model TrackModel(Model model, const char *name) {
+  TrackResource(RESOURCE_MODEL, (size_t)model.meshes, GetModelBytes(model),
+                name);
+  return model;
+}
+
+Shader TrackShader(Shader shader, const char *name) {
+  TrackResource(RESOURCE_SHADER, shader.id, 0, name);
+  return shader;
+}
+
+Font TrackFont(Font font, const char *name) {
+  // NOTE: The default font belongs to raylib, UnloadFont() skips it too
+  if (font.texture.id != GetFontDefault().texture.id)
+    TrackResource(RESOURCE_FONT, font.texture.id,
+                  GetTextureBytes(font.texture), name);
+  return font;
+}
+
+Sound TrackSound(Sound sound, const char *name) {
+  size_t bytes = (size_t)sound.frameCount * sound.stream.channels *
+                 (sound.stream.sampleSize / 8);
+  TrackResource(RESOURCE_SOUND, (size_t)sound.stream.buffer, bytes, name);
+  return sound;
+}
+
+void UnloadTextureTracked(Texture2D texture) {
+  UntrackResource(RESOURCE_TEXTURE, texture.id);
+  UnloadTexture(texture);
+}
+
+void UnloadModelTracked(Model model) {
+  UntrackResource(RESOURCE_MODEL, (size_t)model.meshes);
+  UnloadModel(model);
+}
+
+void UnloadFontTracked(Font font) {
+  UntrackResource(RESOURCE_FONT, font.texture.id);
+  UnloadFont(font);
+}
+
+void UnloadSoundTracked(Sound sound) {
+  UntrackResource(RESOURCE_SOUND, (size_t)sound.stream.buffer);
+  UnloadSound(sound);
+}
+
+int ReportResourceLeaks(const char *owner) {
+  int leaks = 0;
+  size_t bytes = 0;
+
+  for (int i = 0; i < MAX_TRACKED_RESOURCES; i++) {
+    const TrackedResource *resource = &resources[i];
+    if (!resource->live ||
+        ((owner != NULL) && (strcmp(resource->owner, owner) != 0)))
+      continue;
+
+    TraceLog(LOG_WARNING, "RESOURCES: [%s] Leaked %s '%s' (%.1f KB)",
+             resource->owner, kindNames[resource->kind], resource->name,
+             resource->bytes / 1024.0);
+    leaks++;
+    bytes += resource->bytes;
+  }
+
+  const char *scope = (owner != NULL) ? owner : "all owners";
+  if (leaks > 0)
+    TraceLog(LOG_WARNING, "RESOURCES: [%s] %d leak(s), %.1f KB", scope, leaks,
+             bytes / 1024.0);
+  else
+    TraceLog(LOG_INFO, "RESOURCES: [%s] No leaks", scope);
+  return leaks;
+}
+
+size_t GetModelBytes(Model model) {
+  size_t bytes = 0;
+  for (int i = 0; i < model.meshCount; i++)
+    bytes += GetMeshBytes(model.meshes[i]);
+
+  return bytes;
+}
+
+ResourceStats GetResourceStats(void) {
+  ResourceStats stats = {.peakGpuBytes = peakGpuBytes, .untracked = untracked};
+
+  for (int i = 0; i < MAX_TRACKED_RESOURCES; i++) {
+    if (resources[i].live) {
+      stats.live[resources[i].kind]++;
+      stats.bytes[resources[i].kind] += resources[i].bytes;
+    }
+  }
+  stats.gpuBytes = stats.bytes[RESOURCE_TEXTURE] +
+                   stats.bytes[RESOURCE_MODEL] + stats.bytes[RESOURCE_FONT];
+
+  return stats;
+}
+
+const char *GetResourceKindName(ResourceKind kind) { return kindNames[kind]; }
+
+void ToggleResourceOverlay(void) { overlayVisible = !overlayVisible; }
+
+void DrawResourceOverlay(void) {
+  if (!overlayVisible)
+    return;
+
+  ResourceStats stats = GetResourceStats();
+  int width = 220;
+  int height = 30 + (RESOURCE_KIND_COUNT + 1) * 12;
+  int x = GetScreenWidth() - width - 10;
+  int y = GetScreenHeight() - height - 10;
+
+  DrawRectangle(x, y, width, height, Fade(BLACK, 0.75f));
+  DrawText("resource     live        KB", x + 10, y + 8, 10, WHITE);
+  for (int kind = 0; kind < RESOURCE_KIND_COUNT; kind++)
+    DrawText(TextFormat("%-10s %6d %11.1f", kindNames[kind], stats.live[kind],
+                        stats.bytes[kind] / 1024.0),
+             x + 10, y + 24 + kind * 12, 10, LIGHTGRAY);
+  DrawText(TextFormat("gpu %.1f KB, peak %.1f KB", stats.gpuBytes / 1024.0,
+                      stats.peakGpuBytes / 1024.0),
+           x + 10, y + 24 + RESOURCE_KIND_COUNT * 12, 10, YELLOW);
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+static TrackedResource *FindResource(ResourceKind kind, size_t key) {
+  for (int i = 0; i < MAX_TRACKED_RESOURCES; i++) {
+    if (resources[i].live && (resources[i].kind == kind) &&
+        (resources[i].key == key))
+      return &resources[i];
+  }
+
+  return NULL;
+}
+
+static size_t GetTextureBytes(Texture2D texture) {
+  size_t bytes = 0;
+  int width = texture.width;
+  int height = texture.height;
+
+  for (int level = 0; level < texture.mipmaps; level++) {
+    bytes += GetPixelDataSize(width, height, texture.format);
+    width = (width > 1) ? width / 2 : 1;
+    height = (height > 1) ? height / 2 : 1;
+  }
+
+  return bytes;
+}
+
+// Vertex attributes and indices the mesh was uploaded with
+static size_t GetMeshBytes(Mesh mesh) {
+  size_t vertexSize = 0;
+  if (mesh.vertices != NULL)
+    vertexSize += 3 * sizeof(float);
+  if (mesh.texcoords != NULL)
+    vertexSize += 2 * sizeof(float);
+  if (mesh.texcoords2 != NULL)
+    vertexSize += 2 * sizeof(float);
+  if (mesh.normals != NULL)
+    vertexSize += 3 * sizeof(float);
+  if (mesh.tangents != NULL)
+    vertexSize += 4 * sizeof(float);
+  if (mesh.colors != NULL)
+    vertexSize += 4 * sizeof(unsigned char);
+
+  size_t bytes = (size_t)mesh.vertexCount * vertexSize;
+  if (mesh.indices != NULL)
+    bytes += (size_t)mesh.triangleCount * 3 * sizeof(unsigned short);
+  return bytes;
+}
+
+static size_t GetGpuBytes(void) {
+  size_t bytes = 0;
+  for (int i = 0; i < MAX_TRACKED_RESOURCES; i++) {
+    if (resources[i].live && (resources[i].kind != RESOURCE_SHADER) &&
+        (resources[i].kind != RESOURCE_SOUND))
+      bytes += resources[i].bytes;
+  }
+
+  return bytes;
+}
@@ -0,0 +1,96 @@
+/**********************************************************************************************
+ *
+ *   Resource Tracker - Live textures, models, shaders, fonts and sounds
+ *
+ *   Every raylib resource the game keeps past the call that loaded it goes
+ *   through the Track*() helpers, and back out through the matching
+ *   Unload*Tracked() or UntrackResource(). Each live handle is recorded with
+ *   its name, its size and the owner that was current when it was tracked,
+ *   normally the screen being initialized (SetResourceOwner()).
+ *
+ *   ReportResourceLeaks() logs whatever an owner still holds, so calling it
+ *   right after a screen's Unload*Screen() lists exactly what that screen
+ *   forgot to unload; with NULL it reports every owner, for the exit check.
+ *
+ *   Sizes are estimates of what the resource pins: pixel data for textures
+ *   and fonts, vertex and index data for models (uploaded to the GPU and
+ *   still kept on the CPU by raylib), sample data for sounds. Shaders and
+ *   sound aliases count as zero.
+ *
+ *   Main thread only, like the raylib calls it wraps.
+ *
+ **********************************************************************************************/
+
+#ifndef RESOURCE_TRACKER_H
+#define RESOURCE_TRACKER_H
+
+#include "raylib.h"
+#include <stddef.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define MAX_TRACKED_RESOURCES 256
+#define RESOURCE_NAME_LENGTH 48
+#define RESOURCE_OWNER_GLOBAL "global" // Current owner before any screen
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum ResourceKind {
+  RESOURCE_TEXTURE = 0,
+  RESOURCE_MODEL,
+  RESOURCE_SHADER,
+  RESOURCE_FONT,
+  RESOURCE_SOUND,
+  RESOURCE_KIND_COUNT
+} ResourceKind;
+
+typedef struct ResourceStats {
+  int live[RESOURCE_KIND_COUNT];
+  size_t bytes[RESOURCE_KIND_COUNT];
+  size_t gpuBytes; // Textures, fonts and models
+  size_t peakGpuBytes;
+  int untracked; // Resources refused because the table was full, since init
+} ResourceStats;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//----------------------------------------------------------------------------------
+// Resource Tracker Functions Declaration
+//----------------------------------------------------------------------------------
+// owner must stay valid while its resources are live, a string literal
+void SetResourceOwner(const char *owner);
+const char *GetResourceOwner(void);
+
+// key identifies the resource within its kind: GL id or buffer address
+void TrackResource(ResourceKind kind, size_t key, size_t bytes,
+                   const char *name);
+void UntrackResource(ResourceKind kind, size_t key); // Unknown keys are ignored
+
+// Track and return the resource, so loads can be wrapped in place
+Texture2D TrackTexture(Texture2D texture, const char *name);
+Model TrackModel(Model model, const char *name);
+Shader TrackShader(Shader shader, const char *name);
+Font TrackFont(Font font, const char *name);
+Sound TrackSound(Sound sound, const char *name);
+void UnloadTextureTracked(Texture2D texture);
+void UnloadModelTracked(Model model);
+void UnloadFontTracked(Font font);
+void UnloadSoundTracked(Sound sound);
+
+int ReportResourceLeaks(const char *owner); // Returns how many are still live
+ResourceStats GetResourceStats(void);
+size_t GetModelBytes(Model model); // Vertex and index data of every mesh
+const char *GetResourceKindName(ResourceKind kind);
+
+void ToggleResourceOverlay(void);
+void DrawResourceOverlay(void); // Does nothing while the overlay is hidden
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RESOURCE_TRACKER_H
@@ -0,0 +1,21 @@
+#version 100
+
+// Input vertex attributes
+attribute vec3 vertexPosition;
+attribute vec2 vertexTexCoord;
+
+// Per-instance model matrix, bound by DrawMeshInstanced()
+attribute mat4 instanceTransform;
+
+// Input uniform values
+uniform mat4 mvp;
+
+// Output vertex attributes (to fragment shader)
+varying vec2 fragTexCoord;
+
+void main()
+{
+    fragTexCoord = vertexTexCoord;
+
+    gl_Position = mvp*instanceTransform*vec4(vertexPosition, 1.0);
+}
@@ -0,0 +1,221 @@
+/**********************************************************************************************
+ *
+ *   Scenario - Simulation workloads described in small text files
+ *
+ *   See scenario.h for the file format.
+ *
+ **********************************************************************************************/
+
+#include "scenario.h"
+#include "raylib.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum ScenarioValueType {
+  SCENARIO_FLOAT = 0,
+  SCENARIO_ANGLE, // Degrees in the file, radians in the rules
+  SCENARIO_INT,
+  SCENARIO_BOOL,
+  SCENARIO_RANGE, // Two consecutive floats, min then max
+  SCENARIO_ANGLE_RANGE,
+  SCENARIO_SPAWN_AREA,
+} ScenarioValueType;
+
+typedef struct ScenarioKey {
+  const char *name;
+  ScenarioValueType type;
+  size_t offset; // Into SimRules
+} ScenarioKey;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static const ScenarioKey scenarioKeys[] = {
+    {"fire_interval", SCENARIO_FLOAT, offsetof(SimRules, fireInterval)},
+    {"bullets_per_shot", SCENARIO_INT, offsetof(SimRules, bulletsPerShot)},
+    {"bullet_spread", SCENARIO_ANGLE, offsetof(SimRules, bulletSpread)},
+    {"auto_fire", SCENARIO_BOOL, offsetof(SimRules, autoFire)},
+    {"rock_spawn_delay", SCENARIO_FLOAT, offsetof(SimRules, rockSpawnDelay)},
+    {"rock_spawn_interval", SCENARIO_FLOAT,
+     offsetof(SimRules, rockSpawnInterval)},
+    {"rocks_per_wave", SCENARIO_INT, offsetof(SimRules, rocksPerWave)},
+    {"max_rocks", SCENARIO_INT, offsetof(SimRules, maxRocks)},
+    {"rock_spawn_area", SCENARIO_SPAWN_AREA,
+     offsetof(SimRules, rockSpawnArea)},
+    {"rock_speed", SCENARIO_RANGE, offsetof(SimRules, rockSpeedMin)},
+    {"rock_direction", SCENARIO_ANGLE_RANGE, offsetof(SimRules, rockDirMin)},
+    {"rock_radius", SCENARIO_RANGE, offsetof(SimRules, rockRadiusMin)},
+    {"rock_lifetime", SCENARIO_FLOAT, offsetof(SimRules, rockLifeTime)},
+    {"rock_split_count", SCENARIO_INT, offsetof(SimRules, rockSplitCount)},
+    {"rock_min_radius", SCENARIO_FLOAT, offsetof(SimRules, rockMinRadius)},
+};
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static bool ParseLine(Scenario *scenario, char *line);
+static bool ParseValue(SimRules *rules, const ScenarioKey *key,
+                       const char *value);
+static char *TrimSpaces(char *text);
+
+//----------------------------------------------------------------------------------
+// Scenario Functions Definition
+//----------------------------------------------------------------------------------
+
+Scenario GetDefaultScenario(void) {
+  Scenario scenario = {.name = "default", .rules = GetDefaultSimRules()};
+  return scenario;
+}
+
+bool LoadScenario(const char *fileName, Scenario *scenario) {
+  char *text = LoadFileText(fileName);
+  if (text == NULL)
+    return false;
+
+  *scenario = GetDefaultScenario();
+  strncpy(scenario->name, GetFileNameWithoutExt(fileName),
+          sizeof(scenario->name) - 1);
+
+  bool valid = true;
+  int lineNumber = 1;
+  for (char *line = text; (line != NULL) && valid; lineNumber++) {
+    char *end = strchr(line, '\n');
+    if (end != NULL)
+      *end = '\0';
+
+    valid = ParseLine(scenario, line);
+    if (!valid)
+      TraceLog(LOG_WARNING, "SCENARIO: [%s] Invalid line %d: %s", fileName,
+               lineNumber, line);
+
+    line = (end != NULL) ? end + 1 : NULL;
+  }
+  UnloadFileText(text);
+
+  if (valid)
+    TraceLog(LOG_INFO, "SCENARIO: [%s] Loaded \"%s\"", fileName,
+             scenario->name);
+  return valid;
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+// Blank and comment-only lines are valid and change nothing
+static bool ParseLine(Scenario *scenario, char *line) {
+  char *comment = strchr(line, '#');
+  if (comment != NULL)
+    *comment = '\0';
+
+  line = TrimSpaces(line);
+  if (line[0] == '\0')
+    return true;
+
+  char *equals = strchr(line, '=');
+  if (equals == NULL)
+    return false;
+  *equals = '\0';
+  const char *name = TrimSpaces(line);
+  const char *value = TrimSpaces(equals + 1);
+
+  if (strcmp(name, "name") == 0) {
+    strncpy(scenario->name, value, sizeof(scenario->name) - 1);
+    scenario->name[sizeof(scenario->name) - 1] = '\0';
+    return value[0] != '\0';
+  }
+  if (strcmp(name, "duration") == 0) {
+    char *end = NULL;
+    scenario->duration = strtof(value, &end);
+    return (end != value) && (*TrimSpaces(end) == '\0') &&
+           (scenario->duration >= 0.0f);
+  }
+
+  int keyCount = sizeof(scenarioKeys) / sizeof(scenarioKeys[0]);
+  for (int i = 0; i < keyCount; i++) {
+    if (strcmp(name, scenarioKeys[i].name) == 0)
+      return ParseValue(&scenario->rules, &scenarioKeys[i], value);
+  }
+
+  return false;
+}
+
+static bool ParseValue(SimRules *rules, const ScenarioKey *key,
+                       const char *value) {
+  unsigned char *field = (unsigned char *)rules + key->offset;
+  char *end = NULL;
+
+  switch (key->type) {
+  case SCENARIO_FLOAT:
+  case SCENARIO_ANGLE: {
+    float number = strtof(value, &end);
+    if ((end == value) || (*TrimSpaces(end) != '\0') || (number < 0.0f))
+      return false;
+    *(float *)field = (key->type == SCENARIO_ANGLE) ? number * DEG2RAD : number;
+    return true;
+  }
+  case SCENARIO_INT: {
+    long number = strtol(value, &end, 10);
+    if ((end == value) || (*TrimSpaces(end) != '\0') || (number < 0) ||
+        (number > 1000000))
+      return false;
+    *(int *)field = (int)number;
+    return true;
+  }
+  case SCENARIO_BOOL:
+    if ((strcmp(value, "true") == 0) || (strcmp(value, "1") == 0))
+      *(bool *)field = true;
+    else if ((strcmp(value, "false") == 0) || (strcmp(value, "0") == 0))
+      *(bool *)field = false;
+    else
+      return false;
+    return true;
+  case SCENARIO_RANGE:
+  case SCENARIO_ANGLE_RANGE: {
+    float range[2] = {0};
+    range[0] = strtof(value, &end);
+    if (end == value)
+      return false;
+    const char *next = end;
+    range[1] = strtof(next, &end);
+    if (end == next)
+      range[1] = range[0]; // Single value, fixed
+    if ((*TrimSpaces(end) != '\0') || (range[1] < range[0]))
+      return false;
+
+    float scale = (key->type == SCENARIO_ANGLE_RANGE) ? DEG2RAD : 1.0f;
+    ((float *)field)[0] = range[0] * scale;
+    ((float *)field)[1] = range[1] * scale;
+    return true;
+  }
+  case SCENARIO_SPAWN_AREA:
+    if (strcmp(value, "origin") == 0)
+      *(SimSpawnArea *)field = SIM_SPAWN_ORIGIN;
+    else if (strcmp(value, "field") == 0)
+      *(SimSpawnArea *)field = SIM_SPAWN_FIELD;
+    else
+      return false;
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Strips leading and trailing whitespace in place
+static char *TrimSpaces(char *text) {
+  while ((*text == ' ') || (*text == '\t'))
+    text++;
+
+  char *end = text + strlen(text);
+  while ((end > text) && ((end[-1] == ' ') || (end[-1] == '\t') ||
+                          (end[-1] == '\r')))
+    end--;
+  *end = '\0';
+
+  return text;
+}
@@ -0,0 +1,61 @@
+/**********************************************************************************************
+ *
+ *   Scenario - Simulation workloads described in small text files
+ *
+ *   A scenario is a name, a duration and a set of SimRules, written as one
+ *   "key = value" per line; '#' starts a comment and unknown keys are
+ *   rejected, so a typo cannot silently fall back to a default. Ranges take
+ *   "min max", or a single value for both. Angles are in degrees.
+ *
+ *       name = rocks_10k
+ *       duration = 30               # seconds, 0 runs until stopped
+ *       fire_interval = 0           # seconds, 0 fires every tick
+ *       bullets_per_shot = 850
+ *       bullet_spread = 360
+ *       auto_fire = true
+ *       rock_spawn_delay = 0
+ *       rock_spawn_interval = 0.1
+ *       rocks_per_wave = 100
+ *       max_rocks = 10000
+ *       rock_spawn_area = field     # origin or field
+ *       rock_speed = 1 6
+ *       rock_direction = 0 360
+ *       rock_radius = 0.5 1.5
+ *       rock_lifetime = 12
+ *       rock_split_count = 2        # pieces per hit rock, 0 destroys it
+ *       rock_min_radius = 0.5
+ *
+ *   Keys left out keep GetDefaultSimRules() values. See scenarios/ for the
+ *   shipped workloads.
+ *
+ **********************************************************************************************/
+
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include "simulation.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct Scenario {
+  char name[64];
+  float duration; // Seconds of game time, 0 for no limit
+  SimRules rules;
+} Scenario;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//----------------------------------------------------------------------------------
+// Scenario Functions Declaration
+//----------------------------------------------------------------------------------
+Scenario GetDefaultScenario(void); // The game's own rules, no time limit
+bool LoadScenario(const char *fileName, Scenario *scenario);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SCENARIO_H
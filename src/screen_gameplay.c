@@ -27,11 +27,64 @@
  *
  **********************************************************************************************/
 
+#include "asset_loader.h"
+#include "collision_grid.h"
+#include "frame_arena.h"
+#include "hud_text.h"
+#include "instance_renderer.h"
+#include "model_cache.h"
+#include "music_streamer.h"
+#include "particle_system.h"
+#include "resource_tracker.h"
+#include "profiler.h"
 #include "raylib.h"
 #include "raymath.h"
+#include "replay.h"
+#include "scenario.h"
 #include "screens.h"
-#define BULLET_SPEED 5
+#include "simulation.h"
+#include "tagged_heap.h"
+#include "view_culling.h"
+#include "voice_pool.h"
+#include <math.h>
+#include <stddef.h>
 #define radToDegree(rad) (rad * 360 / (2 * PI))
+#define REPLAY_FAST_FORWARD_SPEED 8 // Playback speed while TAB is held
+#define MAX_FRAME_TIME 0.25f        // Longer frames are simulated as this
+#define STEADY_STATE_FRAMES 120     // Frames allowed to grow heap storage
+#define BULLET_BOUNDS_RADIUS 1.02f  // Encloses the 0.25 x 0.25 x 2 bullet cube
+#define HUD_LINE_HEIGHT 20          // Font size too, so the HUD fits 450 px
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum HudLine {
+  HUD_LINE_YAW = 0, // Top of the screen, one HUD_LINE_HEIGHT apart
+  HUD_LINE_COOLDOWN,
+  HUD_LINE_MOUSE,
+  HUD_LINE_PLAYER,
+  HUD_LINE_BULLETS,
+  HUD_LINE_ROCKS,
+  HUD_LINE_MODELS,
+  HUD_LINE_DRAW,
+  HUD_LINE_REPLAY,
+  HUD_LINE_SCENARIO,
+  HUD_LINE_ARENA,
+  HUD_LINE_HEAP,
+  HUD_LINE_PARTICLES,
+  HUD_LINE_CULLING,
+  HUD_LINE_MUSIC,
+  HUD_LINE_VOICES,
+  HUD_LINE_TEXT,
+  HUD_LINE_COUNT
+} HudLine;
+
+typedef enum GameSound {
+  GAME_SOUND_SHOT = 0,
+  GAME_SOUND_IMPACT,
+  GAME_SOUND_EXPLOSION,
+  GAME_SOUND_COUNT
+} GameSound;
 
 //----------------------------------------------------------------------------------
 // Module Variables Definition (local)
@@ -40,55 +93,94 @@
 static const Vector3 UP_VEC = (Vector3){0, 1, 0};
 static const Vector3 UNIT3_VEC = (Vector3){1, 0, 0};
 
-typedef struct playerEntity_t {
-  Model model;
-  Vector2 pos;
-  float dir;
-  float fireCooldown;
-} playerPos_t;
-
-typedef struct bulletEntity_t {
-  Model model;
-  Vector2 pos;
-  float dir;
-} bulletEntity_t;
-
-typedef struct rockEntity_t {
-  Model model;
-  float radius;
-  Vector2 pos;
-  float dir;
-  float speed;
-  float lifeTime;
-  bool status;
-} rockEntity_t;
-
 static int framesCounter = 0;
 static int finishScreen = 0;
 static Camera3D camera = {0};
-static playerPos_t playerEntity;
-static bulletEntity_t *bullets;
-static int numBullets;
-static rockEntity_t *rocks;
-static int numRocks;
-static float fireRate = 0.4;
-static float rockSpawnCooldown = 4.0;
+static Simulation sim = {0};
+static Model playerModel = {0};
+static int frameAllocCount = 0;
 static Vector2 mousePos;
 
 static Texture2D crosshairTexture;
+static AssetHandle playerAsset = ASSET_HANDLE_INVALID;
+static AssetHandle crosshairAsset = ASSET_HANDLE_INVALID;
+static ModelHandle ruleModels[SIM_MAX_MODELS]; // Held while their meshes load
+static AssetHandle ruleModelAssets[SIM_MAX_MODELS];
+static int ruleModelCount = 0;
+
+static const char *replayRecordFile = NULL;   // Session saved here on unload
+static const char *replayPlaybackFile = NULL; // Played instead of live input
+static Replay replay = {0};
+static bool replayPlayback = false;
+
+static Scenario scenario = {0}; // Rules for new sessions, see SetGameplay...
+static bool scenarioSet = false;
+static float scenarioTime = 0.0f; // Game time into the session
+
+static float tickDt = 1.0f / SIM_DEFAULT_TICK_RATE;
+static float tickAccumulator = 0.0f; // Frame time not simulated yet
+static SimInput replayInput = {0};   // Next replay tick, read ahead to know
+static float replayDt = 0.0f;        // whether its dt fits this frame
+static bool replayTickPending = false;
+
+static HudText hudLines[HUD_LINE_COUNT] = {0};
+static int sounds[GAME_SOUND_COUNT] = {0}; // Voice pool effects
 
 static const Vector3 g0 = (Vector3){-22, 0, -12};
 static const Vector3 g1 = (Vector3){22, 0, -12};
 static const Vector3 g2 = (Vector3){22, 0, 12};
 static const Vector3 g3 = (Vector3){-22, 0, 12};
 
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static void EmitTickEffects(SimInput input); // After every simulation tick
+static AssetHandle RequestRuleModelAsset(ModelHandle handle);
+
 //----------------------------------------------------------------------------------
 // Gameplay Screen Functions Definition
 //----------------------------------------------------------------------------------
 
+// Gameplay Screen replay files, either may be NULL
+void SetGameplayReplayFiles(const char *recordFile, const char *playbackFile) {
+  replayRecordFile = recordFile;
+  replayPlaybackFile = playbackFile;
+}
+
+// Gameplay Screen simulation rate, independent of the render rate
+void SetGameplayTickRate(int tickRate) {
+  tickDt = 1.0f / ((tickRate > 0) ? tickRate : SIM_DEFAULT_TICK_RATE);
+}
+
+// Gameplay Screen rules for the next sessions; without a scenario the game
+// plays by GetDefaultSimRules()
+void SetGameplayScenario(const Scenario *newScenario) {
+  scenarioSet = (newScenario != NULL);
+  if (scenarioSet)
+    scenario = *newScenario;
+}
+
+// Gameplay Screen asset requests, decoded while the transition fades out
+void PreloadGameplayScreen(void) {
+  if (playerAsset == ASSET_HANDLE_INVALID)
+    playerAsset = RequestCubeModelAsset(1, 1, 1);
+  if (crosshairAsset == ASSET_HANDLE_INVALID)
+    crosshairAsset = RequestTextureAsset("./resources/crosshair.png");
+
+  // Every model the session's rules can spawn; a replay brings its own rules,
+  // known only once it is loaded, so its other models load in init
+  if (ruleModelCount == 0) {
+    SimRules rules = scenarioSet ? scenario.rules : GetDefaultSimRules();
+    ruleModelCount = AcquireRuleModels(&rules, ruleModels, SIM_MAX_MODELS);
+    for (int i = 0; i < ruleModelCount; i++)
+      ruleModelAssets[i] = RequestRuleModelAsset(ruleModels[i]);
+  }
+}
+
 // Gameplay Screen Initialization logic
 void InitGameplayScreen(void) {
   framesCounter = 0;
+  SetFrameHeapGuard(false);
   finishScreen = 0;
   camera.fovy = 60;
   camera.target = (Vector3){0, 0, 0};
@@ -96,93 +188,55 @@ void InitGameplayScreen(void) {
   camera.up = (Vector3){0, 1, 0};
   camera.projection = CAMERA_PERSPECTIVE;
 
-  Mesh playerMesh = GenMeshCube(1, 1, 1);
-  playerEntity.model = LoadModelFromMesh(playerMesh);
-  playerEntity.pos = Vector2Zero();
-  playerEntity.dir = 0.0f;
-  playerEntity.fireCooldown = fireRate;
-  bullets = MemAlloc(sizeof(bulletEntity_t));
-  rocks = MemAlloc(sizeof(rockEntity_t));
-  numBullets = 0;
-
-  rockSpawnCooldown = 1.0;
-
-  Image crosshairImg = LoadImage("./resources/crosshair.png");
-  crosshairTexture = LoadTextureFromImage(crosshairImg);
-}
-
-void UpdateBullets(void) {
-  int *invalidBulletsIndex = MemAlloc(sizeof(int));
-  int numInvalid = 0;
-
-  for (int i = 0; i < numBullets; i++) {
-    Vector2 newPosVec = Vector2Rotate(
-        Vector2Scale((Vector2){20, 0}, GetFrameTime()), -bullets[i].dir);
-    bullets[i].pos = Vector2Add(bullets[i].pos, newPosVec);
-    int bulletX = bullets[i].pos.x + 20;
-    int bulletY = bullets[i].pos.y + 11;
-    if ((bulletX > 40) || (bulletX < 0) || (bulletY > 22) || (bulletY < 0)) {
-      UnloadModel(bullets[i].model);
-      invalidBulletsIndex[numInvalid] = i;
-      numInvalid++;
-      invalidBulletsIndex =
-          MemRealloc(invalidBulletsIndex, sizeof(int) * (numInvalid + 1));
-    }
-  }
-
-  // Remove bullets from heap
-  int offset = 0;
-  for (int i = 0; i < numInvalid; i++) {
-    int removeIndex = invalidBulletsIndex[i] + offset;
-    for (int j = removeIndex; j < numBullets - 1; j++) {
-      bullets[j] = bullets[j + 1];
-    }
-    numBullets--;
-    offset--;
+  // Free when the transition already loaded them, blocking otherwise
+  PreloadGameplayScreen();
+  playerModel = TakeModelAsset(playerAsset);
+  crosshairTexture = TakeTextureAsset(crosshairAsset);
+  playerAsset = ASSET_HANDLE_INVALID;
+  crosshairAsset = ASSET_HANDLE_INVALID;
+
+  replayPlayback =
+      (replayPlaybackFile != NULL) && LoadReplay(&replay, replayPlaybackFile);
+  if (!scenarioSet)
+    scenario = GetDefaultScenario();
+  scenarioTime = 0.0f;
+  tickAccumulator = 0.0f;
+  replayTickPending = false;
+  if (replayPlayback) {
+    InitSimulationWithRules(&sim, replay.seed, replay.rules);
+  } else {
+    unsigned int seed = (unsigned int)GetRandomValue(1, 0x7fffffff);
+    InitSimulationWithRules(&sim, seed, scenario.rules);
+    if (replayRecordFile != NULL)
+      BeginReplayRecording(&replay, seed, scenario.rules);
   }
-  MemFree(invalidBulletsIndex);
-}
-
-void UpdateRocks() {
-  int *invalidRocksIndex = MemAlloc(sizeof(int));
-  int numInvalid = 0;
-  for (int i = 0; i < numRocks; i++) {
-    Vector2 dRockPos = Vector2Rotate(
-        (Vector2){rocks[i].speed * GetFrameTime(), 0}, rocks[i].dir);
-    rocks[i].pos = Vector2Add(rocks[i].pos, dRockPos);
-
-    rocks[i].lifeTime -= GetFrameTime();
-    if (rocks[i].lifeTime < 0) {
-      UnloadModel(rocks[i].model);
-      invalidRocksIndex[numInvalid] = i;
-      numInvalid++;
-      invalidRocksIndex =
-          MemRealloc(invalidRocksIndex, sizeof(int) * (numInvalid + 1));
-    }
-  }
-
-  int offset = 0;
-  for (int i = 0; i < numInvalid; i++) {
-    int removeIndex = invalidRocksIndex[i] + offset;
-    for (int j = removeIndex; j < numRocks - 1; j++) {
-      rocks[j] = rocks[j + 1];
-    }
-    numRocks--;
-    offset--;
-  }
-  MemFree(invalidRocksIndex);
-}
-
-void CheckEntityCollisions(void) {
-  for (int bulletIndex = 0; bulletIndex < numBullets; bulletIndex++) {
-    for (int rockIndex = 0; rockIndex < numRocks; rockIndex++) {
-      if (CheckCollisionPointCircle(bullets[bulletIndex].pos,
-                                    rocks[rockIndex].pos,
-                                    rocks[rockIndex].radius)) {
-        rocks[rockIndex].status = true;
-      }
+  // Upload every model the rules can spawn now, not when a rock first splits;
+  // the preloaded ones are only handed over to the model cache
+  for (int i = 0; i < ruleModelCount; i++) {
+    if (ruleModelAssets[i] != ASSET_HANDLE_INVALID) {
+      Model model = TakeModelAsset(ruleModelAssets[i]);
+      if (!AdoptCachedModel(ruleModels[i], model))
+        UnloadModelTracked(model);
     }
+    ReleaseModel(ruleModels[i]); // The simulation holds its own references
   }
+  ruleModelCount = 0;
+  for (int i = 0; i < sim.modelCount; i++)
+    GetCachedModel(sim.models[i]);
+
+  InitInstanceRenderer();
+  InitParticleSystem(PARTICLE_DEFAULT_CAPACITY);
+  // NOTE: coin.wav is the only sound shipped, effects are pitched copies
+  sounds[GAME_SOUND_SHOT] = LoadVoiceEffect(fxCoin, 8, 2);
+  sounds[GAME_SOUND_IMPACT] = LoadVoiceEffect(fxCoin, 12, 4);
+  sounds[GAME_SOUND_EXPLOSION] = LoadVoiceEffect(fxCoin, 8, 3);
+  for (int line = 0; line < HUD_LINE_COUNT; line++)
+    InitHudTextDefault(&hudLines[line], 5, 5 + line * HUD_LINE_HEIGHT,
+                       HUD_LINE_HEIGHT, WHITE);
+
+#if defined(_DEBUG)
+  VerifyCollisionGridScenes(20, 1);
+#endif
 }
 
 // Gameplay Screen Update logic
@@ -191,13 +245,76 @@ void UpdateGameplayScreen(void) {
   /* SetMouseOffset(-GetScreenWidth() / 2, -GetScreenHeight() / 2); */
   /* mousePos = GetMousePosition(); */
 
-  Ray mouseRay = GetMouseRay(GetMousePosition(), camera);
-  RayCollision groundHit = GetRayCollisionQuad(mouseRay, g0, g1, g2, g3);
-  mousePos = (Vector2){groundHit.point.x, groundHit.point.z};
+  // Frame time feeds a fixed-rate accumulator, so the world advances in
+  // whole ticks whatever the render rate; a long stall drops time instead of
+  // running a burst of catch-up ticks
+  float frameTime = fminf(GetFrameTime(), MAX_FRAME_TIME);
+  framesCounter++;
+  // Storage sized for the workload by the end of the warm-up has to last
+  SetFrameHeapGuard(framesCounter > STEADY_STATE_FRAMES);
+  BeginVoiceFrame();
+  int allocCountBefore = GetEntityStoreAllocCount();
+  if (replayPlayback) {
+    // Ticks keep their recorded dt, so the world matches the recording
+    // whatever the tick rate was then or is now
+    tickAccumulator +=
+        IsKeyDown(KEY_TAB) ? frameTime * REPLAY_FAST_FORWARD_SPEED : frameTime;
+    while (true) {
+      if (!replayTickPending)
+        replayTickPending = ReadReplayTick(&replay, &replayInput, &replayDt);
+      if (!replayTickPending || (tickAccumulator < replayDt))
+        break;
+
+      mousePos = replayInput.aim;
+      StepSimulation(&sim, replayInput, replayDt);
+      EmitTickEffects(replayInput);
+      tickAccumulator -= replayDt;
+      scenarioTime += replayDt;
+      replayTickPending = false;
+    }
+    if (!replayTickPending)
+      tickAccumulator = 0.0f; // Finished, nothing left to accumulate for
+  } else {
+    BeginProfileZone(PROFILE_ZONE_INPUT);
+    Ray mouseRay = GetMouseRay(GetMousePosition(), camera);
+    RayCollision groundHit = GetRayCollisionQuad(mouseRay, g0, g1, g2, g3);
+    mousePos = (Vector2){groundHit.point.x, groundHit.point.z};
+
+    SimInput input = {.aim = mousePos};
+    if (IsKeyDown(KEY_W))
+      input.move.y -= 1.0f;
+    if (IsKeyDown(KEY_S))
+      input.move.y += 1.0f;
+    if (IsKeyDown(KEY_A))
+      input.move.x -= 1.0f;
+    if (IsKeyDown(KEY_D))
+      input.move.x += 1.0f;
+    input.fire = IsKeyDown(KEY_SPACE) || IsMouseButtonDown(MOUSE_LEFT_BUTTON);
+    EndProfileZone(PROFILE_ZONE_INPUT);
+
+    // The same input applies to every tick this frame
+    tickAccumulator += frameTime;
+    while (tickAccumulator >= tickDt) {
+      if (replayRecordFile != NULL)
+        RecordReplayTick(&replay, input, tickDt);
+      StepSimulation(&sim, input, tickDt);
+      EmitTickEffects(input);
+      tickAccumulator -= tickDt;
+      scenarioTime += tickDt;
+    }
+  }
+  frameAllocCount = GetEntityStoreAllocCount() - allocCountBefore;
+
+  // Effects follow the render rate, they never feed back into the world
+  BeginProfileZone(PROFILE_ZONE_PARTICLES);
+  UpdateParticles(frameTime);
+  EndProfileZone(PROFILE_ZONE_PARTICLES);
+
+  // A timed scenario ends the session by itself, like pressing enter
+  if (!replayPlayback && (scenario.duration > 0.0f) &&
+      (scenarioTime >= scenario.duration))
+    finishScreen = 1;
 
-  UpdateBullets();
-  UpdateRocks();
-  CheckEntityCollisions();
   // Press enter or tap to change to ENDING screen
   if (IsKeyPressed(KEY_F)) {
     if (IsWindowFullscreen()) {
@@ -209,59 +326,16 @@ void UpdateGameplayScreen(void) {
       ToggleFullscreen();
     }
   }
+  if (IsKeyPressed(KEY_I)) {
+    SetInstancingEnabled(!IsInstancingEnabled());
+  }
+  if (IsKeyPressed(KEY_H)) {
+    SetHudTextCaching(!IsHudTextCaching());
+  }
   if (IsKeyPressed(KEY_ENTER)) {
     finishScreen = 1;
     PlaySound(fxCoin);
   }
-  if (IsKeyDown(KEY_W)) {
-    playerEntity.pos.y -= 10.0f * GetFrameTime();
-  }
-  if (IsKeyDown(KEY_S)) {
-    playerEntity.pos.y += 10.0f * GetFrameTime();
-  }
-  if (IsKeyDown(KEY_A)) {
-    playerEntity.pos.x -= 10.0f * GetFrameTime();
-  }
-  if (IsKeyDown(KEY_D)) {
-    playerEntity.pos.x += 10.0f * GetFrameTime();
-  }
-  playerEntity.dir = Vector2Angle(Vector2Subtract(mousePos, playerEntity.pos),
-                                  ((Vector2){1, 0}));
-  if ((playerEntity.fireCooldown <= 0) &&
-      (IsKeyDown(KEY_SPACE) || IsMouseButtonDown(MOUSE_LEFT_BUTTON))) {
-    bulletEntity_t bullet;
-    Mesh bulletMesh = GenMeshCube(0.25, 0.25, 2.0);
-    bullet.model = LoadModelFromMesh(bulletMesh);
-
-    Vector2 spawnOffset = Vector2Rotate((Vector2){1, 0}, -playerEntity.dir);
-    Vector2 spawnVec = Vector2Add(playerEntity.pos, spawnOffset);
-    bullet.pos = spawnVec;
-    bullet.dir = playerEntity.dir;
-    bullets[numBullets] = bullet;
-    numBullets++;
-    bullets = MemRealloc(bullets, sizeof(bulletEntity_t) * (numBullets + 1));
-    playerEntity.fireCooldown = fireRate;
-  }
-  if (rockSpawnCooldown <= 0) {
-    float radius = GetRandomValue(0, 10) / 8.0 + 2.5;
-    Mesh rockMesh = GenMeshSphere(radius, 10, 10);
-    rocks[numRocks] = (rockEntity_t){
-        .model = LoadModelFromMesh(rockMesh),
-        .radius = radius,
-        .pos = Vector2Zero(),
-        .dir = 0,
-        .speed = 5.0,
-        .lifeTime = 5.0,
-        .status = false,
-    };
-    numRocks++;
-    rocks = MemRealloc(rocks, sizeof(rockEntity_t) * (numRocks + 1));
-    rockSpawnCooldown = 4.0;
-  }
-
-  float frameTime = GetFrameTime();
-  rockSpawnCooldown -= frameTime;
-  playerEntity.fireCooldown -= frameTime;
 }
 
 // Gameplay Screen Draw logic
@@ -271,32 +345,74 @@ void DrawGameplayScreen(void) {
   // DrawTextEx(font, "GAMEPLAY SCREEN", pos, font.baseSize * 3.0f, 4,
   // MAROON); DrawText("PRESS ENTER or TAP to JUMP to ENDING SCREEN", 130,
   // 220, 20, MAROON);
+  // Draw between the last two ticks, by how far the accumulator has got
+  // towards the next one
+  float alpha = 1.0f;
+  if (replayPlayback)
+    alpha = replayTickPending ? tickAccumulator / replayDt : 1.0f;
+  else
+    alpha = tickAccumulator / tickDt;
+  alpha = Clamp(alpha, 0.0f, 1.0f);
+
+  Vector2 playerPos = Vector2Lerp(sim.prevPlayer.pos, sim.player.pos, alpha);
+  float playerTurn = sim.player.dir - sim.prevPlayer.dir;
+  if (playerTurn > PI)
+    playerTurn -= 2 * PI;
+  else if (playerTurn < -PI)
+    playerTurn += 2 * PI;
+  float playerDir = sim.prevPlayer.dir + playerTurn * alpha;
+
+  BeginProfileZone(PROFILE_ZONE_DRAW_3D);
   BeginMode3D(camera);
-  Vector3 playerPosition = (Vector3){playerEntity.pos.x, 0, playerEntity.pos.y};
+  Vector3 playerPosition = (Vector3){playerPos.x, 0, playerPos.y};
   /* DrawCube(playerPosition, 1, 1, 1, BLUE); */
   /* DrawCubeWires(playerPosition, 1, 1, 1, WHITE); */
-  DrawModelEx(playerEntity.model, playerPosition, UP_VEC,
-              radToDegree(playerEntity.dir), Vector3One(), BLUE);
-  DrawModelWiresEx(playerEntity.model, playerPosition, UP_VEC,
-                   radToDegree(playerEntity.dir), Vector3One(), WHITE);
+  DrawModelEx(playerModel, playerPosition, UP_VEC, radToDegree(playerDir),
+              Vector3One(), BLUE);
+  DrawModelWiresEx(playerModel, playerPosition, UP_VEC, radToDegree(playerDir),
+                   Vector3One(), WHITE);
 
   Vector3 lookingVec =
       Vector3Add(playerPosition,
-                 Vector3RotateByAxisAngle(UNIT3_VEC, UP_VEC, playerEntity.dir));
+                 Vector3RotateByAxisAngle(UNIT3_VEC, UP_VEC, playerDir));
   DrawLine3D(playerPosition, lookingVec, RED);
 
-  for (int i = 0; i < numBullets; i++) {
-    Vector3 bulletPos = (Vector3){bullets[i].pos.x, 0, bullets[i].pos.y};
-    DrawModelEx(bullets[i].model, bulletPos, UP_VEC,
-                radToDegree(bullets[i].dir) + 90, Vector3One(), RED);
+  // Entities outside the view or off the play field are not drawn at all
+  BeginViewCulling(camera, (float)GetScreenWidth() / GetScreenHeight(),
+                   (Rectangle){g0.x, g0.z, g2.x - g0.x, g2.z - g0.z});
+
+  BeginInstanceBatch();
+  const EntityStore *bullets = &sim.bullets;
+  for (int i = 0; i < bullets->count; i++) {
+    float x = Lerp(bullets->prevPosX[i], bullets->posX[i], alpha);
+    float y = Lerp(bullets->prevPosY[i], bullets->posY[i], alpha);
+    if (!IsSphereVisible((Vector3){x, 0, y}, BULLET_BOUNDS_RADIUS))
+      continue;
+    Matrix bulletTransform = MatrixMultiply(
+        MatrixRotateY(bullets->dir[i] + PI / 2), MatrixTranslate(x, 0, y));
+    PushInstance(bullets->model[i], bulletTransform, RED, false);
   }
 
-  for (int i = 0; i < numRocks; i++) {
-    Color rockColor = (rocks[i].status) ? RED : GRAY;
-    Vector3 rockPos = (Vector3){rocks[i].pos.x, 0, rocks[i].pos.y};
-    DrawModelEx(rocks[i].model, rockPos, UP_VEC, 0.0, Vector3One(), rockColor);
-    DrawModelWiresEx(rocks[i].model, rockPos, UP_VEC, 0.0, Vector3One(), WHITE);
+  const EntityStore *rocks = &sim.rocks;
+  for (int i = 0; i < rocks->count; i++) {
+    float x = Lerp(rocks->prevPosX[i], rocks->posX[i], alpha);
+    float y = Lerp(rocks->prevPosY[i], rocks->posY[i], alpha);
+    if (!IsSphereVisible((Vector3){x, 0, y}, rocks->radius[i]))
+      continue;
+    Color rockColor = (rocks->flags[i] & ENTITY_FLAG_DEBRIS) ? RED : GRAY;
+    // NOTE: The shared mesh has the quantized radius, scaled back to the one
+    // used for collisions
+    float scale = GetModelScale(rocks->model[i], rocks->radius[i]);
+    Matrix rockTransform = MatrixMultiply(MatrixScale(scale, scale, scale),
+                                          MatrixTranslate(x, 0, y));
+    PushInstance(rocks->model[i], rockTransform, rockColor, false);
+    PushInstance(rocks->model[i], rockTransform, WHITE, true);
   }
+  FlushInstanceBatch();
+
+  BeginProfileZone(PROFILE_ZONE_DRAW_FX);
+  DrawParticles();
+  EndProfileZone(PROFILE_ZONE_DRAW_FX);
 
   /* Vector3 mouse = (Vector3){mousePos.x, 0, mousePos.y}; */
   Vector2 mouse = (Vector2){GetMouseX() - 16 * 2, GetMouseY() - 16 * 2};
@@ -304,25 +420,168 @@ void DrawGameplayScreen(void) {
   /* DrawCubeWires(mouse, 1, 1, 1, WHITE); */
   /* DrawBillboard(camera, crosshairTexture, mouse, 20.0, RED); */
   EndMode3D();
-
-  DrawText(TextFormat("Yaw: %f", playerEntity.dir), 5, 5, 30, WHITE);
-  DrawText(TextFormat("Cooldown: %f", playerEntity.fireCooldown), 5, 35, 30,
-           WHITE);
-  DrawText(TextFormat("Mouse: %f %f", mousePos.x, mousePos.y), 5, 65, 30,
-           WHITE);
-  DrawText(TextFormat("Player: %f %f", playerEntity.pos.x, playerEntity.pos.y),
-           5, 95, 30, WHITE);
-  DrawText(TextFormat("Bullets: %d", numBullets), 5, 125, 30, WHITE);
-  DrawText(TextFormat("Rocks: %d", numRocks), 5, 155, 30, WHITE);
+  EndProfileZone(PROFILE_ZONE_DRAW_3D);
+
+  // Labels only lay their text out again when it changed
+  BeginProfileZone(PROFILE_ZONE_DRAW_HUD);
+  BeginHudTextBatch();
+  SetHudTextFormat(&hudLines[HUD_LINE_YAW], "Yaw: %f", sim.player.dir);
+  SetHudTextFormat(&hudLines[HUD_LINE_COOLDOWN], "Cooldown: %f",
+                   sim.player.fireCooldown);
+  SetHudTextFormat(&hudLines[HUD_LINE_MOUSE], "Mouse: %f %f", mousePos.x,
+                   mousePos.y);
+  SetHudTextFormat(&hudLines[HUD_LINE_PLAYER],
+                   "Player: %f %f (tick %.0f Hz, draw %d fps)",
+                   sim.player.pos.x, sim.player.pos.y, 1.0f / tickDt,
+                   GetFPS());
+  SetHudTextFormat(&hudLines[HUD_LINE_BULLETS], "Bullets: %d",
+                   bullets->count);
+  SetHudTextFormat(&hudLines[HUD_LINE_ROCKS],
+                   "Rocks: %d (allocs this frame: %d)", rocks->count,
+                   frameAllocCount);
+  ModelCacheStats cacheStats = GetModelCacheStats();
+  SetHudTextFormat(&hudLines[HUD_LINE_MODELS],
+                   "Models: %d loaded %d unloaded %d live", cacheStats.loads,
+                   cacheStats.unloads, cacheStats.liveModels);
+  InstanceRendererStats drawStats = GetInstanceRendererStats();
+  SetHudTextFormat(&hudLines[HUD_LINE_DRAW],
+                   "Draw [I]: %s, %d calls for %d instances",
+                   drawStats.instanced ? "instanced" : "per entity",
+                   drawStats.drawCalls, drawStats.instances);
+  if (replayPlayback) {
+    if (IsReplayFinished(&replay))
+      SetHudTextFormat(&hudLines[HUD_LINE_REPLAY],
+                       "Replay finished, checksum %s",
+                       (GetSimulationChecksum(&sim) == replay.checksum)
+                           ? "matches"
+                           : "DIFFERS");
+    else
+      SetHudTextFormat(&hudLines[HUD_LINE_REPLAY],
+                       "Replay tick %u/%u [TAB] fast forward",
+                       replay.cursorTick, replay.tickCount);
+  }
+  if (scenarioSet)
+    SetHudTextFormat(&hudLines[HUD_LINE_SCENARIO], "Scenario: %s, %.1f s",
+                     scenario.name, scenarioTime);
+  FrameArenaStats arenaStats = GetFrameArenaStats();
+  SetHudTextFormat(&hudLines[HUD_LINE_ARENA],
+                   "Arena: %d/%d KB peak, %d overflows, %d heap allocs",
+                   (int)(arenaStats.highWater / 1024),
+                   (int)(arenaStats.capacity / 1024), arenaStats.overflows,
+                   arenaStats.guardedHeapAllocs);
+  MemTagStats heapStats = GetTaggedHeapTotals();
+  SetHudTextFormat(&hudLines[HUD_LINE_HEAP],
+                   "Heap: %d KB live, %d KB peak, %d allocs %d frees/frame",
+                   (int)(heapStats.liveBytes / 1024),
+                   (int)(heapStats.peakBytes / 1024), heapStats.frameAllocs,
+                   heapStats.frameFrees);
+  ParticleStats particleStats = GetParticleStats();
+  SetHudTextFormat(&hudLines[HUD_LINE_PARTICLES],
+                   "Particles: %d live, update %.2f ms, draw %.2f ms",
+                   particleStats.live,
+                   GetProfileZoneLastMs(PROFILE_ZONE_PARTICLES),
+                   GetProfileZoneLastMs(PROFILE_ZONE_DRAW_FX));
+  ViewCullingStats cullStats = GetViewCullingStats();
+  SetHudTextFormat(&hudLines[HUD_LINE_CULLING], "Culling: %d drawn, %d culled",
+                   cullStats.drawn, cullStats.culled);
+  MusicStreamerStats musicStats = GetMusicStreamerStats();
+  if (musicStats.threaded)
+    SetHudTextFormat(&hudLines[HUD_LINE_MUSIC],
+                     "Music: %3d%% buffered, %u underruns",
+                     musicStats.buffered * 100 / musicStats.capacity,
+                     musicStats.underruns);
+  else
+    SetHudText(&hudLines[HUD_LINE_MUSIC], "Music: decoded on the main thread");
+  VoicePoolStats voiceStats = GetVoicePoolStats();
+  SetHudTextFormat(&hudLines[HUD_LINE_VOICES],
+                   "Voices: %d/%d playing, %d stolen, %d dropped",
+                   voiceStats.playing, voiceStats.voices, voiceStats.stolen,
+                   voiceStats.limited + voiceStats.outranked);
+  HudTextStats textStats = GetHudTextStats();
+  SetHudTextFormat(&hudLines[HUD_LINE_TEXT],
+                   "Text [H]: %s, %d of %d labels rebuilt",
+                   IsHudTextCaching() ? "cached" : "laid out per frame",
+                   textStats.rebuilds, textStats.widgets);
+
+  for (int line = 0; line < HUD_LINE_COUNT; line++) {
+    if (((line == HUD_LINE_REPLAY) && !replayPlayback) ||
+        ((line == HUD_LINE_SCENARIO) && !scenarioSet))
+      continue;
+    PushHudText(&hudLines[line]);
+  }
+  FlushHudTextBatch();
   DrawTextureEx(crosshairTexture, mouse, 0.0, 2.0, WHITE);
+  EndProfileZone(PROFILE_ZONE_DRAW_HUD);
 }
 
 // Gameplay Screen Unload logic
 void UnloadGameplayScreen(void) {
-  MemFree(bullets);
-  MemFree(rocks);
-  UnloadModel(playerEntity.model);
+  SetFrameHeapGuard(false); // Unloading frees and the next screen may load
+  if (!replayPlayback && (replayRecordFile != NULL)) {
+    EndReplayRecording(&replay, &sim);
+    SaveReplay(&replay, replayRecordFile);
+  }
+  UnloadReplay(&replay);
+  replayPlayback = false;
+
+  UnloadSimulation(&sim);
+  TrimModelCache();
+  UnloadInstanceRenderer();
+  UnloadParticleSystem();
+  UnloadVoicePool();
+  UnloadModelTracked(playerModel);
+  UnloadTextureTracked(crosshairTexture);
+  playerModel = (Model){0};
+  crosshairTexture = (Texture2D){0};
 }
 
 // Gameplay Screen should finish?
 int FinishGameplayScreen(void) { return finishScreen; }
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+// Hits leave sparks, debris and sounds, shots a sound, a moving player
+// leaves a trail behind it
+static void EmitTickEffects(SimInput input) {
+  for (int i = 0; i < sim.eventCount; i++) {
+    const SimEvent *event = &sim.events[i];
+    switch (event->type) {
+    case SIM_EVENT_BULLET_HIT:
+      EmitParticles(PARTICLE_EFFECT_IMPACT, event->pos, event->dir + PI, 1.0f);
+      PlayVoice(sounds[GAME_SOUND_IMPACT], 0, 0.4f, 1.4f);
+      break;
+    case SIM_EVENT_ROCK_HIT:
+      EmitParticles(PARTICLE_EFFECT_EXPLOSION, event->pos, event->dir,
+                    event->radius);
+      // Bigger rocks sound deeper and win voices over small debris
+      PlayVoice(sounds[GAME_SOUND_EXPLOSION], (int)event->radius, 0.8f,
+                0.8f / fmaxf(event->radius, 1.0f));
+      break;
+    case SIM_EVENT_SHOT:
+      PlayVoice(sounds[GAME_SOUND_SHOT], 0, 0.25f, 2.0f);
+      break;
+    default:
+      break;
+    }
+  }
+
+  if ((input.move.x != 0.0f) || (input.move.y != 0.0f))
+    EmitParticles(PARTICLE_EFFECT_TRAIL, sim.player.pos,
+                  atan2f(-input.move.y, -input.move.x), 1.0f);
+}
+
+// Same shape the model cache would generate, ASSET_HANDLE_INVALID when the
+// model is already loaded
+static AssetHandle RequestRuleModelAsset(ModelHandle handle) {
+  ModelKind kind = MODEL_KIND_BULLET;
+  float param = 0.0f;
+  if (!GetPendingModel(handle, &kind, &param))
+    return ASSET_HANDLE_INVALID;
+
+  if (kind == MODEL_KIND_ROCK)
+    return RequestSphereModelAsset(param, ROCK_MODEL_RINGS, ROCK_MODEL_SLICES);
+  return RequestCubeModelAsset(BULLET_MODEL_WIDTH, BULLET_MODEL_WIDTH,
+                               BULLET_MODEL_LENGTH);
+}
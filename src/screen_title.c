@@ -25,6 +25,7 @@
 
 #include "raylib.h"
 #include "screens.h"
+#include "hud_text.h"
 
 //----------------------------------------------------------------------------------
 // Module Variables Definition (local)
@@ -32,6 +33,9 @@
 static int framesCounter = 0;
 static int finishScreen = 0;
 
+static HudText titleText = { 0 };
+static HudText promptText = { 0 };
+
 //----------------------------------------------------------------------------------
 // Title Screen Functions Definition
 //----------------------------------------------------------------------------------
@@ -42,6 +46,12 @@ void InitTitleScreen(void)
     // TODO: Initialize TITLE screen variables here!
     framesCounter = 0;
     finishScreen = 0;
+
+    // Static text, laid out once here instead of every frame
+    InitHudText(&titleText, font, (Vector2){ 20, 10 }, font.baseSize*3.0f, 4, DARKGREEN);
+    SetHudText(&titleText, "TITLE SCREEN");
+    InitHudTextDefault(&promptText, 120, 220, 20, DARKGREEN);
+    SetHudText(&promptText, "PRESS ENTER or TAP to JUMP to GAMEPLAY SCREEN");
 }
 
 // Title Screen Update logic
@@ -63,9 +73,10 @@ void DrawTitleScreen(void)
 {
     // TODO: Draw TITLE screen here!
     DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(), GREEN);
-    Vector2 pos = { 20, 10 };
-    DrawTextEx(font, "TITLE SCREEN", pos, font.baseSize*3.0f, 4, DARKGREEN);
-    DrawText("PRESS ENTER or TAP to JUMP to GAMEPLAY SCREEN", 120, 220, 20, DARKGREEN);
+    BeginHudTextBatch();
+    PushHudText(&titleText);
+    PushHudText(&promptText);
+    FlushHudTextBatch();
 }
 
 // Title Screen Unload logic
@@ -26,6 +26,8 @@
 #ifndef SCREENS_H
 #define SCREENS_H
 
+#include "scenario.h"
+
 //----------------------------------------------------------------------------------
 // Types and Structures Definition
 //----------------------------------------------------------------------------------
@@ -36,7 +38,6 @@ typedef enum GameScreen { UNKNOWN = -1, LOGO = 0, TITLE, OPTIONS, GAMEPLAY, ENDI
 //----------------------------------------------------------------------------------
 extern GameScreen currentScreen;
 extern Font font;
-extern Music music;
 extern Sound fxCoin;
 
 #ifdef __cplusplus
@@ -73,6 +74,10 @@ int FinishOptionsScreen(void);
 //----------------------------------------------------------------------------------
 // Gameplay Screen Functions Declaration
 //----------------------------------------------------------------------------------
+void PreloadGameplayScreen(void);   // Queue assets on the background loader
+void SetGameplayReplayFiles(const char *recordFile, const char *playbackFile);
+void SetGameplayScenario(const Scenario *scenario); // NULL for default
+void SetGameplayTickRate(int tickRate); // Simulation ticks per second
 void InitGameplayScreen(void);
 void UpdateGameplayScreen(void);
 void DrawGameplayScreen(void);
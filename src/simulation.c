@@ -0,0 +1,525 @@
+/**********************************************************************************************
+ *
+ *   Simulation - Gameplay rules, independent of windowing, input and timing
+ *
+ *   See simulation.h for the determinism contract.
+ *
+ **********************************************************************************************/
+
+#include "simulation.h"
+#include "collision_grid.h"
+#include "entity_kernels.h"
+#include "job_system.h"
+#include "model_cache.h"
+#include "profiler.h"
+#include "raylib.h"
+#include "raymath.h"
+#include <math.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+// Smallest slice of entities worth handing to another thread
+#define SIM_PARALLEL_MIN_CHUNK 2048
+
+// Rock radii come in this many steps between min and max, which keeps the
+// number of distinct rock models small
+#define SIM_ROCK_RADIUS_STEPS 10
+
+// Half extents of the play field, as the bullet bounds check uses them
+#define SIM_FIELD_HALF_WIDTH 20.0f
+#define SIM_FIELD_HALF_HEIGHT 11.0f
+
+// Pieces of a broken rock are this much smaller and faster than the rock
+#define SIM_SPLIT_RADIUS_SCALE 0.5f
+#define SIM_SPLIT_SPEED_SCALE 1.5f
+
+// Entity pools are reserved for the rules' worst case, up to this size;
+// past it stores grow on demand like before
+#define SIM_MAX_POOL_CAPACITY (1 << 20)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct IntegrateJob {
+  EntityStore *store;
+  float dt;
+} IntegrateJob;
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static void SavePreviousPositions(EntityStore *store);
+static void IntegrateBullets(void *data, int begin, int end);
+static void IntegrateRocks(void *data, int begin, int end);
+static void RemoveDespawned(EntityStore *store);
+static int SimRandomValue(Simulation *sim, int min, int max);
+static float SimRandomRange(Simulation *sim, float min, float max);
+static void UpdatePlayer(Simulation *sim, SimInput input, float dt);
+static void SpawnBullet(Simulation *sim, float angleOffset);
+static void SpawnRock(Simulation *sim);
+static bool CanSplitRock(const SimRules *rules, float radius);
+static void SplitRock(Simulation *sim, int rock);
+static void ReservePools(Simulation *sim);
+static bool AddRuleModel(ModelHandle *models, int *modelCount, int maxModels,
+                         ModelKind kind, float param);
+static void PushEvent(Simulation *sim, SimEventType type, Vector2 pos,
+                      Vector2 velocity, float radius);
+static unsigned int HashBytes(unsigned int hash, const void *data, int size);
+
+//----------------------------------------------------------------------------------
+// Simulation Functions Definition
+//----------------------------------------------------------------------------------
+
+void InitSimulation(Simulation *sim, unsigned int seed) {
+  InitSimulationWithRules(sim, seed, GetDefaultSimRules());
+}
+
+void InitSimulationWithRules(Simulation *sim, unsigned int seed,
+                             SimRules rules) {
+  *sim = (Simulation){0};
+  sim->rules = rules;
+  sim->player.pos = Vector2Zero();
+  sim->player.dir = 0.0f;
+  sim->player.fireCooldown = rules.fireInterval;
+  sim->prevPlayer = sim->player;
+  sim->rockSpawnCooldown = rules.rockSpawnDelay;
+  sim->rngState = (seed != 0) ? seed : 0x9e3779b9; // xorshift must not be 0
+
+  InitEntityStore(&sim->bullets, 256, MEM_TAG_BULLETS);
+  InitEntityStore(&sim->rocks, ENTITY_STORE_MIN_CAPACITY, MEM_TAG_ROCKS);
+  ReservePools(sim);
+  sim->modelCount = AcquireRuleModels(&sim->rules, sim->models, SIM_MAX_MODELS);
+  sim->events = TaggedAlloc(MEM_TAG_EVENTS, sizeof(SimEvent) * SIM_MAX_EVENTS);
+}
+
+void UnloadSimulation(Simulation *sim) {
+  for (int i = 0; i < sim->bullets.count; i++)
+    ReleaseModel(sim->bullets.model[i]);
+  for (int i = 0; i < sim->rocks.count; i++)
+    ReleaseModel(sim->rocks.model[i]);
+  for (int i = 0; i < sim->modelCount; i++)
+    ReleaseModel(sim->models[i]);
+
+  UnloadEntityStore(&sim->bullets);
+  UnloadEntityStore(&sim->rocks);
+  UnloadCollisionGrid();
+  TaggedFree(sim->events);
+  sim->events = NULL;
+}
+
+// One rock every four seconds from the centre, one bullet every 0.4 seconds,
+// rocks breaking in two until the pieces would be smaller than one unit
+SimRules GetDefaultSimRules(void) {
+  SimRules rules = {
+      .fireInterval = 0.4f,
+      .bulletsPerShot = 1,
+      .bulletSpread = 0.0f,
+      .autoFire = false,
+      .rockSpawnDelay = 1.0f,
+      .rockSpawnInterval = 4.0f,
+      .rocksPerWave = 1,
+      .maxRocks = 0,
+      .rockSpawnArea = SIM_SPAWN_ORIGIN,
+      .rockSpeedMin = SIM_ROCK_SPEED,
+      .rockSpeedMax = SIM_ROCK_SPEED,
+      .rockDirMin = 0.0f,
+      .rockDirMax = 0.0f,
+      .rockRadiusMin = 2.5f,
+      .rockRadiusMax = 3.75f,
+      .rockLifeTime = 5.0f,
+      .rockSplitCount = 2,
+      .rockMinRadius = 1.0f,
+  };
+
+  return rules;
+}
+
+// The bullet, every spawn radius and every piece radius below them
+int AcquireRuleModels(const SimRules *rules, ModelHandle *models,
+                      int maxModels) {
+  float radiusStep =
+      (rules->rockRadiusMax - rules->rockRadiusMin) / SIM_ROCK_RADIUS_STEPS;
+  int modelCount = 0;
+  int dropped = 0;
+
+  dropped += !AddRuleModel(models, &modelCount, maxModels, MODEL_KIND_BULLET,
+                           0.0f);
+  for (int step = 0; step <= SIM_ROCK_RADIUS_STEPS; step++) {
+    float radius = rules->rockRadiusMin + step * radiusStep;
+    dropped += !AddRuleModel(models, &modelCount, maxModels, MODEL_KIND_ROCK,
+                             radius);
+    while (CanSplitRock(rules, radius)) {
+      radius *= SIM_SPLIT_RADIUS_SCALE;
+      dropped += !AddRuleModel(models, &modelCount, maxModels,
+                               MODEL_KIND_ROCK, radius);
+    }
+  }
+
+  if (dropped > 0)
+    TraceLog(LOG_WARNING,
+             "SIMULATION: Rules need more than %d models, %d not held",
+             maxModels, dropped);
+  return modelCount;
+}
+
+void StepSimulation(Simulation *sim, SimInput input, float dt) {
+  sim->eventCount = 0;
+  sim->prevPlayer = sim->player;
+  SavePreviousPositions(&sim->bullets);
+  SavePreviousPositions(&sim->rocks);
+
+  BeginProfileZone(PROFILE_ZONE_BULLETS);
+  UpdateBullets(sim, dt);
+  EndProfileZone(PROFILE_ZONE_BULLETS);
+  BeginProfileZone(PROFILE_ZONE_ROCKS);
+  UpdateRocks(sim, dt);
+  EndProfileZone(PROFILE_ZONE_ROCKS);
+  BeginProfileZone(PROFILE_ZONE_COLLISIONS);
+  CheckEntityCollisions(sim);
+  BreakHitRocks(sim);
+  EndProfileZone(PROFILE_ZONE_COLLISIONS);
+  UpdatePlayer(sim, input, dt);
+
+  BeginProfileZone(PROFILE_ZONE_SPAWNING);
+  const SimRules *rules = &sim->rules;
+  if ((sim->player.fireCooldown <= 0) && (input.fire || rules->autoFire)) {
+    for (int i = 0; i < rules->bulletsPerShot; i++) {
+      float offset = (rules->bulletsPerShot > 1)
+                         ? rules->bulletSpread *
+                               ((float)i / (rules->bulletsPerShot - 1) - 0.5f)
+                         : 0.0f;
+      SpawnBullet(sim, offset);
+    }
+    PushEvent(sim, SIM_EVENT_SHOT, sim->player.pos,
+              Vector2Rotate((Vector2){1, 0}, -sim->player.dir), 0.0f);
+    sim->player.fireCooldown = rules->fireInterval;
+  }
+  if (sim->rockSpawnCooldown <= 0) {
+    for (int i = 0; i < rules->rocksPerWave; i++) {
+      if ((rules->maxRocks > 0) && (sim->rocks.count >= rules->maxRocks))
+        break;
+      SpawnRock(sim);
+    }
+    sim->rockSpawnCooldown = rules->rockSpawnInterval;
+  }
+  EndProfileZone(PROFILE_ZONE_SPAWNING);
+
+  sim->rockSpawnCooldown -= dt;
+  sim->player.fireCooldown -= dt;
+  sim->tick++;
+}
+
+unsigned int GetSimulationChecksum(const Simulation *sim) {
+  const EntityStore *bullets = &sim->bullets;
+  const EntityStore *rocks = &sim->rocks;
+  unsigned int hash = 2166136261u; // FNV-1a offset basis
+
+  hash = HashBytes(hash, &sim->tick, sizeof(sim->tick));
+  hash = HashBytes(hash, &sim->player, sizeof(sim->player));
+  hash = HashBytes(hash, &bullets->count, sizeof(bullets->count));
+  hash = HashBytes(hash, bullets->posX, sizeof(float) * bullets->count);
+  hash = HashBytes(hash, bullets->posY, sizeof(float) * bullets->count);
+  hash = HashBytes(hash, &rocks->count, sizeof(rocks->count));
+  hash = HashBytes(hash, rocks->posX, sizeof(float) * rocks->count);
+  hash = HashBytes(hash, rocks->posY, sizeof(float) * rocks->count);
+  hash = HashBytes(hash, rocks->flags, rocks->count);
+
+  return hash;
+}
+
+// Integration and lifetime checks run on the job system and only flag
+// entities; releasing models and compacting stay on this thread, in index
+// order, so any thread count produces the same store as a serial update
+void UpdateBullets(Simulation *sim, float dt) {
+  IntegrateJob job = {&sim->bullets, dt};
+
+  RunParallelFor(sim->bullets.count, SIM_PARALLEL_MIN_CHUNK, IntegrateBullets,
+                 &job);
+  RemoveDespawned(&sim->bullets);
+}
+
+void UpdateRocks(Simulation *sim, float dt) {
+  IntegrateJob job = {&sim->rocks, dt};
+
+  RunParallelFor(sim->rocks.count, SIM_PARALLEL_MIN_CHUNK, IntegrateRocks,
+                 &job);
+  RemoveDespawned(&sim->rocks);
+}
+
+void CheckEntityCollisions(Simulation *sim) {
+  EntityStore *bullets = &sim->bullets;
+  EntityStore *rocks = &sim->rocks;
+
+  BuildCollisionGrid(rocks);
+
+  for (int bulletIndex = 0; bulletIndex < bullets->count; bulletIndex++) {
+    Vector2 bulletPos =
+        (Vector2){bullets->posX[bulletIndex], bullets->posY[bulletIndex]};
+    int numCandidates = 0;
+    const int *candidates =
+        GetCollisionGridCell(bulletPos.x, bulletPos.y, &numCandidates);
+    for (int i = 0; i < numCandidates; i++) {
+      int rockIndex = candidates[i];
+      if (rocks->flags[rockIndex] & ENTITY_FLAG_DEAD)
+        continue; // Already broken by an earlier bullet this tick
+      if (CheckCollisionPointCircle(
+              bulletPos,
+              (Vector2){rocks->posX[rockIndex], rocks->posY[rockIndex]},
+              rocks->radius[rockIndex])) {
+        rocks->flags[rockIndex] |= ENTITY_FLAG_HIT | ENTITY_FLAG_DEAD;
+        bullets->flags[bulletIndex] |= ENTITY_FLAG_DEAD;
+        PushEvent(sim, SIM_EVENT_BULLET_HIT, bulletPos,
+                  (Vector2){bullets->velX[bulletIndex],
+                            bullets->velY[bulletIndex]},
+                  0.0f);
+        PushEvent(sim, SIM_EVENT_ROCK_HIT,
+                  (Vector2){rocks->posX[rockIndex], rocks->posY[rockIndex]},
+                  (Vector2){rocks->velX[rockIndex], rocks->velY[rockIndex]},
+                  rocks->radius[rockIndex]);
+        break; // One rock per bullet
+      }
+    }
+  }
+}
+
+// Pieces go on the end of the store and are not split again this tick;
+// removal comes last, so the indices stay valid while splitting
+void BreakHitRocks(Simulation *sim) {
+  EntityStore *rocks = &sim->rocks;
+
+  int hitCandidates = rocks->count;
+  for (int i = 0; i < hitCandidates; i++) {
+    if (rocks->flags[i] & ENTITY_FLAG_HIT)
+      SplitRock(sim, i);
+  }
+
+  RemoveDespawned(&sim->bullets);
+  RemoveDespawned(rocks);
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+static void SavePreviousPositions(EntityStore *store) {
+  memcpy(store->prevPosX, store->posX, sizeof(float) * store->count);
+  memcpy(store->prevPosY, store->posY, sizeof(float) * store->count);
+}
+
+static void IntegrateBullets(void *data, int begin, int end) {
+  IntegrateJob *job = data;
+  IntegrateBulletRange(job->store, job->dt, begin, end);
+}
+
+static void IntegrateRocks(void *data, int begin, int end) {
+  IntegrateJob *job = data;
+  IntegrateRockRange(job->store, job->dt, begin, end);
+}
+
+// NOTE: The model cache is not thread safe, so references are only dropped
+// here, after the parallel part
+static void RemoveDespawned(EntityStore *store) {
+  for (int i = 0; i < store->count; i++) {
+    if (store->flags[i] & ENTITY_FLAG_DEAD)
+      ReleaseModel(store->model[i]);
+  }
+
+  CompactEntityStore(store);
+}
+
+// Inclusive range, like GetRandomValue(), from a per-simulation xorshift32
+static int SimRandomValue(Simulation *sim, int min, int max) {
+  unsigned int x = sim->rngState;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  sim->rngState = x;
+
+  return min + (int)(x % (unsigned int)(max - min + 1));
+}
+
+// Uniform in [min, max]; an empty range returns min without drawing
+static float SimRandomRange(Simulation *sim, float min, float max) {
+  if (max <= min)
+    return min;
+
+  return min + (max - min) * SimRandomValue(sim, 0, 0xffff) / 65535.0f;
+}
+
+static void UpdatePlayer(Simulation *sim, SimInput input, float dt) {
+  PlayerState *player = &sim->player;
+
+  player->pos.x += input.move.x * SIM_PLAYER_SPEED * dt;
+  player->pos.y += input.move.y * SIM_PLAYER_SPEED * dt;
+  player->dir =
+      Vector2Angle(Vector2Subtract(input.aim, player->pos), ((Vector2){1, 0}));
+}
+
+static void SpawnBullet(Simulation *sim, float angleOffset) {
+  EntityStore *bullets = &sim->bullets;
+  float dir = sim->player.dir + angleOffset;
+  Vector2 spawnOffset = Vector2Rotate((Vector2){1, 0}, -dir);
+  Vector2 spawnVec = Vector2Add(sim->player.pos, spawnOffset);
+  Vector2 velocity = Vector2Scale(spawnOffset, SIM_BULLET_SPEED);
+
+  int bullet = SpawnEntity(bullets);
+  bullets->model[bullet] = AcquireModel(MODEL_KIND_BULLET, 0.0f);
+  bullets->posX[bullet] = spawnVec.x;
+  bullets->posY[bullet] = spawnVec.y;
+  bullets->prevPosX[bullet] = spawnVec.x; // Appears in place, no streak
+  bullets->prevPosY[bullet] = spawnVec.y;
+  bullets->velX[bullet] = velocity.x;
+  bullets->velY[bullet] = velocity.y;
+  bullets->dir[bullet] = dir;
+}
+
+static void SpawnRock(Simulation *sim) {
+  EntityStore *rocks = &sim->rocks;
+  const SimRules *rules = &sim->rules;
+  float radiusStep =
+      (rules->rockRadiusMax - rules->rockRadiusMin) / SIM_ROCK_RADIUS_STEPS;
+  float radius = rules->rockRadiusMin +
+                 SimRandomValue(sim, 0, SIM_ROCK_RADIUS_STEPS) * radiusStep;
+  float speed = SimRandomRange(sim, rules->rockSpeedMin, rules->rockSpeedMax);
+  float dir = SimRandomRange(sim, rules->rockDirMin, rules->rockDirMax);
+  Vector2 pos = Vector2Zero();
+  if (rules->rockSpawnArea == SIM_SPAWN_FIELD) {
+    pos.x = SimRandomRange(sim, -SIM_FIELD_HALF_WIDTH, SIM_FIELD_HALF_WIDTH);
+    pos.y = SimRandomRange(sim, -SIM_FIELD_HALF_HEIGHT, SIM_FIELD_HALF_HEIGHT);
+  }
+
+  int rock = SpawnEntity(rocks);
+  rocks->model[rock] = AcquireModel(MODEL_KIND_ROCK, radius);
+  rocks->radius[rock] = radius;
+  rocks->posX[rock] = pos.x;
+  rocks->posY[rock] = pos.y;
+  rocks->prevPosX[rock] = pos.x;
+  rocks->prevPosY[rock] = pos.y;
+  rocks->velX[rock] = speed * cosf(dir);
+  rocks->velY[rock] = speed * sinf(dir);
+  rocks->dir[rock] = dir;
+  rocks->lifeTime[rock] = rules->rockLifeTime;
+}
+
+// Pieces below a model quantum would all share one degenerate sphere
+static bool CanSplitRock(const SimRules *rules, float radius) {
+  float pieceRadius = radius * SIM_SPLIT_RADIUS_SCALE;
+
+  return (rules->rockSplitCount > 0) &&
+         (pieceRadius >= rules->rockMinRadius) &&
+         (pieceRadius >= 1.0f / ROCK_RADIUS_QUANTUM);
+}
+
+static void SplitRock(Simulation *sim, int rock) {
+  EntityStore *rocks = &sim->rocks;
+  const SimRules *rules = &sim->rules;
+  if (!CanSplitRock(rules, rocks->radius[rock]))
+    return;
+
+  // Copied out first, spawning may move the arrays
+  float radius = rocks->radius[rock] * SIM_SPLIT_RADIUS_SCALE;
+  float posX = rocks->posX[rock];
+  float posY = rocks->posY[rock];
+  float speed = fmaxf(hypotf(rocks->velX[rock], rocks->velY[rock]),
+                      SIM_ROCK_SPEED) *
+                SIM_SPLIT_SPEED_SCALE;
+  float lifeTime = rocks->lifeTime[rock];
+
+  // Evenly spread around a random heading
+  float baseDir = SimRandomRange(sim, 0.0f, 2.0f * PI);
+  for (int i = 0; i < rules->rockSplitCount; i++) {
+    float dir = baseDir + 2.0f * PI * i / rules->rockSplitCount;
+
+    int piece = SpawnEntity(rocks);
+    rocks->model[piece] = AcquireModel(MODEL_KIND_ROCK, radius);
+    rocks->flags[piece] = ENTITY_FLAG_DEBRIS;
+    rocks->radius[piece] = radius;
+    rocks->posX[piece] = posX;
+    rocks->posY[piece] = posY;
+    rocks->prevPosX[piece] = posX;
+    rocks->prevPosY[piece] = posY;
+    rocks->velX[piece] = speed * cosf(dir);
+    rocks->velY[piece] = speed * sinf(dir);
+    rocks->dir[piece] = dir;
+    rocks->lifeTime[piece] = lifeTime; // Pieces never outlive their rock
+  }
+}
+
+// Sized for the most entities the rules can have alive at once, at the
+// default tick rate: every shot still in flight across the field's diagonal,
+// and every rock still alive broken into its smallest pieces
+static void ReservePools(Simulation *sim) {
+  const SimRules *rules = &sim->rules;
+  float minInterval = 1.0f / SIM_DEFAULT_TICK_RATE; // One spawn per tick
+
+  float flightTime =
+      2.0f * hypotf(SIM_FIELD_HALF_WIDTH, SIM_FIELD_HALF_HEIGHT) /
+      SIM_BULLET_SPEED;
+  float bullets = rules->bulletsPerShot *
+                  (flightTime / fmaxf(rules->fireInterval, minInterval) + 1.0f);
+
+  float rocks =
+      (rules->maxRocks > 0)
+          ? rules->maxRocks
+          : rules->rocksPerWave *
+                (rules->rockLifeTime /
+                     fmaxf(rules->rockSpawnInterval, minInterval) +
+                 1.0f);
+  for (float radius = rules->rockRadiusMax;
+       CanSplitRock(rules, radius) && (rocks < SIM_MAX_POOL_CAPACITY);
+       radius *= SIM_SPLIT_RADIUS_SCALE)
+    rocks *= (rules->rockSplitCount > 1) ? rules->rockSplitCount : 1;
+
+  ReserveEntityStore(&sim->bullets,
+                     (int)fminf(ceilf(bullets), SIM_MAX_POOL_CAPACITY));
+  ReserveEntityStore(&sim->rocks,
+                     (int)fminf(ceilf(rocks), SIM_MAX_POOL_CAPACITY));
+}
+
+// Keeps one reference per distinct model, false when there was no room left
+static bool AddRuleModel(ModelHandle *models, int *modelCount, int maxModels,
+                         ModelKind kind, float param) {
+  ModelHandle handle = AcquireModel(kind, param);
+  if (handle == MODEL_HANDLE_INVALID)
+    return true; // The model cache logs its own failures
+
+  for (int i = 0; i < *modelCount; i++) {
+    if (models[i] == handle) {
+      ReleaseModel(handle);
+      return true;
+    }
+  }
+  if (*modelCount == maxModels) {
+    ReleaseModel(handle);
+    return false;
+  }
+
+  models[(*modelCount)++] = handle;
+  return true;
+}
+
+static void PushEvent(Simulation *sim, SimEventType type, Vector2 pos,
+                      Vector2 velocity, float radius) {
+  if ((sim->events == NULL) || (sim->eventCount == SIM_MAX_EVENTS))
+    return;
+
+  sim->events[sim->eventCount++] = (SimEvent){
+      .type = type,
+      .pos = pos,
+      .dir = atan2f(velocity.y, velocity.x),
+      .radius = radius,
+  };
+}
+
+static unsigned int HashBytes(unsigned int hash, const void *data, int size) {
+  const unsigned char *bytes = data;
+
+  for (int i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 16777619u; // FNV-1a prime
+  }
+
+  return hash;
+}
@@ -0,0 +1,142 @@
+/**********************************************************************************************
+ *
+ *   Simulation - Gameplay rules, independent of windowing, input and timing
+ *
+ *   StepSimulation() advances the world by an explicit dt from an explicit
+ *   SimInput, so the same inputs, seed and dt sequence always produce the
+ *   same world. Nothing in here opens a window, polls a device or touches the
+ *   GPU, which lets the headless runner drive it on machines without either.
+ *
+ *   Every tick first saves the player and entity positions as they were, so
+ *   a renderer running at its own rate can draw between the last two ticks.
+ *
+ *   A bullet that hits a rock is spent, and the rock breaks into
+ *   rockSplitCount smaller pieces until they would drop below rockMinRadius.
+ *   Bullet and rock stores are reserved at init for the most the rules can
+ *   have alive at once, so a chain of splits never reaches the heap.
+ *
+ *   Each tick also leaves a list of SimEvents, the shots and hits, for
+ *   effects to pick up before the next tick clears it. Nothing in the
+ *   simulation reads them back and they are not part of the checksum.
+ *
+ *   Entities keep model handles for the renderer; acquiring one is pure
+ *   bookkeeping, meshes are only generated when something draws them. Init
+ *   acquires every model the rules can spawn into Simulation.models, so a
+ *   renderer can upload them all before the first tick.
+ *
+ **********************************************************************************************/
+
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "entity_store.h"
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define SIM_DEFAULT_TICK_RATE 60
+#define SIM_PLAYER_SPEED 10.0f
+#define SIM_BULLET_SPEED 20.0f
+#define SIM_ROCK_SPEED 5.0f
+#define SIM_MAX_MODELS 48 // Distinct bullet and rock models the rules may use
+#define SIM_MAX_EVENTS 4096 // Per tick, later ones are dropped
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct SimInput {
+  Vector2 move; // Per axis -1, 0 or 1, y grows towards the camera
+  Vector2 aim;  // Play-field point the player faces
+  bool fire;
+} SimInput;
+
+typedef enum SimSpawnArea {
+  SIM_SPAWN_ORIGIN = 0, // Play-field centre
+  SIM_SPAWN_FIELD,      // Uniform over the play field
+} SimSpawnArea;
+
+// Spawn and fire tunables. Ranges are uniform, min == max draws nothing from
+// the RNG, so the defaults replay the same as before they were configurable.
+typedef struct SimRules {
+  float fireInterval;  // Seconds between shots
+  int bulletsPerShot;  // Fanned evenly over bulletSpread around the aim
+  float bulletSpread;  // Radians
+  bool autoFire;       // Fire whatever the input says
+
+  float rockSpawnDelay;    // Seconds before the first wave
+  float rockSpawnInterval; // Seconds between waves
+  int rocksPerWave;
+  int maxRocks; // Waves are cut short at this many live rocks, 0 no limit
+  SimSpawnArea rockSpawnArea;
+  float rockSpeedMin, rockSpeedMax;
+  float rockDirMin, rockDirMax; // Radians, 0 is +x
+  float rockRadiusMin, rockRadiusMax;
+  float rockLifeTime;
+  int rockSplitCount;  // Pieces a hit rock breaks into, 0 just destroys it
+  float rockMinRadius; // Pieces never get smaller than this
+} SimRules;
+
+typedef enum SimEventType {
+  SIM_EVENT_BULLET_HIT = 0, // A bullet hit a rock and was spent
+  SIM_EVENT_ROCK_HIT,       // A rock was hit and broke up
+  SIM_EVENT_SHOT,           // The player fired, once per volley
+} SimEventType;
+
+typedef struct SimEvent {
+  SimEventType type;
+  Vector2 pos;
+  float dir;    // Radians, direction of travel, 0 is +x
+  float radius; // Rock radius, 0 for bullets and shots
+} SimEvent;
+
+typedef struct PlayerState {
+  Vector2 pos;
+  float dir;
+  float fireCooldown;
+} PlayerState;
+
+typedef struct Simulation {
+  PlayerState player;
+  PlayerState prevPlayer; // Before the last tick, for interpolated drawing
+  EntityStore bullets;
+  EntityStore rocks;
+  SimRules rules;
+  ModelHandle models[SIM_MAX_MODELS]; // Held from init to unload
+  int modelCount;
+  SimEvent *events; // Last tick's, SIM_MAX_EVENTS long
+  int eventCount;
+  float rockSpawnCooldown;
+  unsigned int rngState;
+  unsigned int tick;
+} Simulation;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//----------------------------------------------------------------------------------
+// Simulation Functions Declaration
+//----------------------------------------------------------------------------------
+void InitSimulation(Simulation *sim, unsigned int seed); // Default rules
+void InitSimulationWithRules(Simulation *sim, unsigned int seed,
+                             SimRules rules);
+SimRules GetDefaultSimRules(void);
+// Acquires one reference to every model the rules can spawn, returns how many
+int AcquireRuleModels(const SimRules *rules, ModelHandle *models,
+                      int maxModels);
+void UnloadSimulation(Simulation *sim); // Releases entity model handles too
+void StepSimulation(Simulation *sim, SimInput input, float dt);
+unsigned int GetSimulationChecksum(const Simulation *sim);
+
+// Individual update phases, in the order StepSimulation() runs them
+void UpdateBullets(Simulation *sim, float dt);
+void UpdateRocks(Simulation *sim, float dt);
+void CheckEntityCollisions(Simulation *sim); // Flags hits only
+void BreakHitRocks(Simulation *sim);         // Splits and removes them
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIMULATION_H
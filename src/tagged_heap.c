@@ -0,0 +1,305 @@
+/**********************************************************************************************
+ *
+ *   Tagged Heap - Attributed heap allocations with per-tag statistics
+ *
+ *   See tagged_heap.h for what is counted and when guards are checked.
+ *
+ **********************************************************************************************/
+
+#include "tagged_heap.h"
+#include "frame_arena.h"
+#include "raylib.h"
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define BLOCK_MAGIC 0x7a6b4d31u         // Live, no guards
+#define BLOCK_MAGIC_GUARDED 0x7a6b4d47u // Live, guard bytes around the data
+#define BLOCK_MAGIC_FREED 0xdeadf4eeu
+#define GUARD_BYTE 0xfd
+#define BLOCK_ALIGNMENT 16 // Of the data, relative to the backend's pointer
+
+// Header space, rounded up so 32-bit targets keep the alignment too
+#define BLOCK_HEADER_SIZE                                                      \
+  ((sizeof(BlockHeader) + BLOCK_ALIGNMENT - 1) &                               \
+   ~(size_t)(BLOCK_ALIGNMENT - 1))
+#define BLOCK_DATA_OFFSET (BLOCK_HEADER_SIZE + TAGGED_HEAP_GUARD_SIZE)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// A block is laid out as header, front guard, data and, when guarded, a back
+// guard. The front guard space is there even when unused, so the header sits
+// at a fixed offset from the data
+typedef struct BlockHeader {
+  struct BlockHeader *prev; // Live blocks, for CheckTaggedHeapGuards()
+  struct BlockHeader *next;
+  size_t size; // Requested, without header and guards
+  unsigned int tag;
+  unsigned int magic;
+} BlockHeader;
+
+// Compile-time check that the data keeps the backend's alignment (C99 has no
+// static assert, a negative array size fails the build instead)
+typedef char
+    BlockDataAligned[(BLOCK_DATA_OFFSET % BLOCK_ALIGNMENT == 0) ? 1 : -1];
+
+typedef struct TagCounters {
+  MemTagStats stats;
+  int frameAllocs; // Frame in progress
+  int frameFrees;
+  size_t frameBytes;
+} TagCounters;
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static void *DefaultAlloc(size_t size);
+static void DefaultFree(void *ptr);
+static BlockHeader *GetBlockHeader(void *ptr); // NULL when ptr is not live
+static unsigned char *GetBlockData(BlockHeader *block);
+static bool CheckGuards(BlockHeader *block);
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static const char *tagNames[MEM_TAG_COUNT] = {
+    "other",  "bullets",   "rocks",    "collision", "events",
+    "replay", "particles", "renderer", "arena",
+};
+
+static TaggedHeapBackend backend = {DefaultAlloc, DefaultFree};
+static TagCounters counters[MEM_TAG_COUNT] = {0};
+static BlockHeader *liveBlocks = NULL;
+static size_t liveBytes = 0;
+static size_t peakBytes = 0;
+static bool guardsEnabled = false;
+
+//----------------------------------------------------------------------------------
+// Tagged Heap Functions Definition
+//----------------------------------------------------------------------------------
+
+void *TaggedAlloc(MemTag tag, size_t size) {
+  if ((tag < 0) || (tag >= MEM_TAG_COUNT))
+    tag = MEM_TAG_OTHER;
+
+  size_t backGuard = guardsEnabled ? TAGGED_HEAP_GUARD_SIZE : 0;
+  BlockHeader *block = backend.alloc(BLOCK_DATA_OFFSET + size + backGuard);
+  if (block == NULL) {
+    TraceLog(LOG_WARNING, "HEAP: [%s] Failed to allocate %zu bytes",
+             tagNames[tag], size);
+    return NULL;
+  }
+
+  block->size = size;
+  block->tag = tag;
+  block->magic = guardsEnabled ? BLOCK_MAGIC_GUARDED : BLOCK_MAGIC;
+  block->prev = NULL;
+  block->next = liveBlocks;
+  if (liveBlocks != NULL)
+    liveBlocks->prev = block;
+  liveBlocks = block;
+
+  unsigned char *data = GetBlockData(block);
+  if (guardsEnabled) {
+    memset(data - TAGGED_HEAP_GUARD_SIZE, GUARD_BYTE, TAGGED_HEAP_GUARD_SIZE);
+    memset(data + size, GUARD_BYTE, TAGGED_HEAP_GUARD_SIZE);
+  }
+
+  TagCounters *tagCounters = &counters[tag];
+  tagCounters->stats.liveBytes += size;
+  if (tagCounters->stats.liveBytes > tagCounters->stats.peakBytes)
+    tagCounters->stats.peakBytes = tagCounters->stats.liveBytes;
+  tagCounters->stats.liveBlocks++;
+  tagCounters->stats.allocs++;
+  tagCounters->frameAllocs++;
+  tagCounters->frameBytes += size;
+
+  liveBytes += size;
+  if (liveBytes > peakBytes)
+    peakBytes = liveBytes;
+
+  NoteHeapAllocation(tagNames[tag], size); // Reallocations come through here
+  return data;
+}
+
+void *TaggedRealloc(MemTag tag, void *ptr, size_t size) {
+  if (ptr == NULL)
+    return TaggedAlloc(tag, size);
+  if (size == 0) {
+    TaggedFree(ptr);
+    return NULL;
+  }
+
+  BlockHeader *block = GetBlockHeader(ptr);
+  if (block == NULL)
+    return NULL; // Already logged, a foreign block cannot be moved safely
+
+  // NOTE: Always a new block, so the guards follow the current setting and
+  // the growth comes zeroed from the backend
+  void *moved = TaggedAlloc(tag, size);
+  if (moved == NULL)
+    return NULL; // The old block stays valid, as with realloc()
+
+  memcpy(moved, ptr, (block->size < size) ? block->size : size);
+  TaggedFree(ptr);
+  return moved;
+}
+
+void TaggedFree(void *ptr) {
+  if (ptr == NULL)
+    return;
+
+  BlockHeader *block = GetBlockHeader(ptr);
+  if (block == NULL)
+    return; // Leaked rather than handed to the backend
+
+  CheckGuards(block);
+
+  TagCounters *tagCounters = &counters[block->tag];
+  tagCounters->stats.liveBytes -= block->size;
+  tagCounters->stats.liveBlocks--;
+  tagCounters->stats.frees++;
+  tagCounters->frameFrees++;
+  liveBytes -= block->size;
+
+  if (block->prev != NULL)
+    block->prev->next = block->next;
+  else
+    liveBlocks = block->next;
+  if (block->next != NULL)
+    block->next->prev = block->prev;
+
+  block->magic = BLOCK_MAGIC_FREED;
+  backend.free(block);
+}
+
+void SetTaggedHeapBackend(TaggedHeapBackend newBackend) {
+  if (liveBlocks != NULL) {
+    TraceLog(LOG_WARNING, "HEAP: Blocks still live, backend not changed");
+    return;
+  }
+  if ((newBackend.alloc == NULL) || (newBackend.free == NULL))
+    newBackend = (TaggedHeapBackend){DefaultAlloc, DefaultFree};
+
+  backend = newBackend;
+}
+
+void SetTaggedHeapGuards(bool enabled) { guardsEnabled = enabled; }
+
+int CheckTaggedHeapGuards(void) {
+  int damaged = 0;
+  for (BlockHeader *block = liveBlocks; block != NULL; block = block->next)
+    damaged += !CheckGuards(block);
+
+  return damaged;
+}
+
+void EndTaggedHeapFrame(void) {
+  for (int tag = 0; tag < MEM_TAG_COUNT; tag++) {
+    TagCounters *tagCounters = &counters[tag];
+    tagCounters->stats.frameAllocs = tagCounters->frameAllocs;
+    tagCounters->stats.frameFrees = tagCounters->frameFrees;
+    tagCounters->stats.frameBytes = tagCounters->frameBytes;
+    tagCounters->frameAllocs = 0;
+    tagCounters->frameFrees = 0;
+    tagCounters->frameBytes = 0;
+  }
+}
+
+int ReportTaggedHeapLeaks(void) {
+  for (int tag = 0; tag < MEM_TAG_COUNT; tag++) {
+    const MemTagStats *stats = &counters[tag].stats;
+    if (stats->liveBlocks > 0)
+      TraceLog(LOG_WARNING, "HEAP: [%s] %d block(s) still live, %.1f KB",
+               tagNames[tag], stats->liveBlocks, stats->liveBytes / 1024.0);
+  }
+
+  MemTagStats totals = GetTaggedHeapTotals();
+  if (totals.liveBlocks == 0)
+    TraceLog(LOG_INFO, "HEAP: No leaks, peak %.1f KB over %d allocations",
+             totals.peakBytes / 1024.0, totals.allocs);
+  if (totals.corruptions > 0)
+    TraceLog(LOG_WARNING, "HEAP: %d corruption(s) detected",
+             totals.corruptions);
+  return totals.liveBlocks;
+}
+
+MemTagStats GetMemTagStats(MemTag tag) {
+  if ((tag < 0) || (tag >= MEM_TAG_COUNT))
+    return (MemTagStats){0};
+
+  return counters[tag].stats;
+}
+
+MemTagStats GetTaggedHeapTotals(void) {
+  MemTagStats totals = {.liveBytes = liveBytes, .peakBytes = peakBytes};
+
+  for (int tag = 0; tag < MEM_TAG_COUNT; tag++) {
+    const MemTagStats *stats = &counters[tag].stats;
+    totals.liveBlocks += stats->liveBlocks;
+    totals.allocs += stats->allocs;
+    totals.frees += stats->frees;
+    totals.corruptions += stats->corruptions;
+    totals.frameAllocs += stats->frameAllocs;
+    totals.frameFrees += stats->frameFrees;
+    totals.frameBytes += stats->frameBytes;
+  }
+
+  return totals;
+}
+
+const char *GetMemTagName(MemTag tag) {
+  if ((tag < 0) || (tag >= MEM_TAG_COUNT))
+    return "?";
+
+  return tagNames[tag];
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+static void *DefaultAlloc(size_t size) { return MemAlloc((unsigned int)size); }
+
+static void DefaultFree(void *ptr) { MemFree(ptr); }
+
+static BlockHeader *GetBlockHeader(void *ptr) {
+  BlockHeader *block =
+      (BlockHeader *)((unsigned char *)ptr - BLOCK_DATA_OFFSET);
+  if ((block->magic == BLOCK_MAGIC) || (block->magic == BLOCK_MAGIC_GUARDED))
+    return block;
+
+  counters[MEM_TAG_OTHER].stats.corruptions++;
+  TraceLog(LOG_ERROR, "HEAP: %s block %p",
+           (block->magic == BLOCK_MAGIC_FREED) ? "Double free of" : "Unknown",
+           ptr);
+  return NULL;
+}
+
+static unsigned char *GetBlockData(BlockHeader *block) {
+  return (unsigned char *)block + BLOCK_DATA_OFFSET;
+}
+
+// Logs and counts a damaged guard against the block's tag
+static bool CheckGuards(BlockHeader *block) {
+  if (block->magic != BLOCK_MAGIC_GUARDED)
+    return true;
+
+  unsigned char *data = GetBlockData(block);
+  bool front = true;
+  bool back = true;
+  for (int i = 0; i < TAGGED_HEAP_GUARD_SIZE; i++) {
+    front = front && (data[-1 - i] == GUARD_BYTE);
+    back = back && (data[block->size + i] == GUARD_BYTE);
+  }
+  if (front && back)
+    return true;
+
+  const char *where = !front ? (!back ? "around" : "before") : "past";
+  counters[block->tag].stats.corruptions++;
+  TraceLog(LOG_ERROR, "HEAP: [%s] Write %s %zu byte block %p",
+           tagNames[block->tag], where, block->size, (void *)data);
+  return false;
+}
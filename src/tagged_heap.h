@@ -0,0 +1,101 @@
+/**********************************************************************************************
+ *
+ *   Tagged Heap - Attributed heap allocations with per-tag statistics
+ *
+ *   TaggedAlloc(), TaggedRealloc() and TaggedFree() stand in for raylib's
+ *   MemAlloc(), MemRealloc() and MemFree() wherever memory stays inside the
+ *   game. Every block carries a small header with its size and MemTag, so
+ *   live bytes, peak, block and call counts are kept per subsystem, and
+ *   EndTaggedHeapFrame() closes a frame's churn counts (allocations and
+ *   frees since the previous call) for the HUD or a report. Every
+ *   allocation is also reported to the frame heap guard, NoteHeapAllocation()
+ *   in frame_arena.h, under its tag's name.
+ *
+ *   Blocks come from a pluggable backend, MemAlloc()/MemFree() by default.
+ *   With SetTaggedHeapGuards() on, new blocks also get guard bytes on both
+ *   sides, checked when they are freed or reallocated and by
+ *   CheckTaggedHeapGuards(); a damaged guard is logged and counted as a
+ *   corruption against the block's tag. Freeing a pointer that did not come
+ *   from here, or freeing twice, is usually caught and counted the same way
+ *   (best effort, the header of a freed block may already be reused).
+ *
+ *   Memory handed over to raylib (mesh arrays, image data) must keep using
+ *   MemAlloc(), since raylib frees it with MemFree().
+ *
+ *   Main thread only; nothing in the loader or job threads allocates
+ *   through it.
+ *
+ **********************************************************************************************/
+
+#ifndef TAGGED_HEAP_H
+#define TAGGED_HEAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define TAGGED_HEAP_GUARD_SIZE 16 // Bytes on each side of a guarded block
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum MemTag {
+  MEM_TAG_OTHER = 0,
+  MEM_TAG_BULLETS,   // Bullet entity store
+  MEM_TAG_ROCKS,     // Rock entity store
+  MEM_TAG_COLLISION, // Collision grid index arrays
+  MEM_TAG_EVENTS,    // Simulation event list
+  MEM_TAG_REPLAY,
+  MEM_TAG_PARTICLES,
+  MEM_TAG_RENDERER, // Instance transform batches
+  MEM_TAG_ARENA,    // The frame arena block
+  MEM_TAG_COUNT
+} MemTag;
+
+typedef struct MemTagStats {
+  size_t liveBytes;
+  size_t peakBytes;
+  int liveBlocks;
+  int allocs; // Allocations and reallocations, since init
+  int frees;
+  int corruptions; // Damaged guards, bad or double frees
+  // Churn of the last frame closed by EndTaggedHeapFrame()
+  int frameAllocs;
+  int frameFrees;
+  size_t frameBytes; // Allocated, not freed
+} MemTagStats;
+
+typedef struct TaggedHeapBackend {
+  void *(*alloc)(size_t size); // Must return zeroed memory
+  void (*free)(void *ptr);
+} TaggedHeapBackend;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//----------------------------------------------------------------------------------
+// Tagged Heap Functions Declaration
+//----------------------------------------------------------------------------------
+void *TaggedAlloc(MemTag tag, size_t size); // Zeroed, like MemAlloc()
+// Moves the block to tag; growth is zeroed too
+void *TaggedRealloc(MemTag tag, void *ptr, size_t size);
+void TaggedFree(void *ptr); // NULL is ignored
+
+void SetTaggedHeapBackend(TaggedHeapBackend backend); // Only with no block live
+void SetTaggedHeapGuards(bool enabled);               // Blocks allocated later
+int CheckTaggedHeapGuards(void); // Checks every live block, returns damaged
+
+void EndTaggedHeapFrame(void);
+int ReportTaggedHeapLeaks(void); // Logs live blocks per tag, returns how many
+MemTagStats GetMemTagStats(MemTag tag);
+MemTagStats GetTaggedHeapTotals(void); // Peak is of the total, not summed
+const char *GetMemTagName(MemTag tag);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TAGGED_HEAP_H
@@ -0,0 +1,102 @@
+/**********************************************************************************************
+ *
+ *   View Culling - Skip entities the camera cannot see before drawing them
+ *
+ *   See view_culling.h for what counts as visible.
+ *
+ **********************************************************************************************/
+
+#include "view_culling.h"
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include <math.h>
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static Vector4 planes[6] = {0}; // Normal in xyz, pointing inside, offset in w
+static Rectangle playField = {0};
+static ViewCullingStats stats = {0};
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static Vector4 NormalizePlane(Vector4 plane);
+
+//----------------------------------------------------------------------------------
+// View Culling Functions Definition
+//----------------------------------------------------------------------------------
+
+void BeginViewCulling(Camera3D camera, float aspect, Rectangle field) {
+  // Same projection BeginMode3D() loads
+  Matrix projection = {0};
+  if (camera.projection == CAMERA_PERSPECTIVE) {
+    projection = MatrixPerspective(camera.fovy * DEG2RAD, aspect,
+                                   RL_CULL_DISTANCE_NEAR, RL_CULL_DISTANCE_FAR);
+  } else {
+    double top = camera.fovy / 2.0;
+    double right = top * aspect;
+    projection = MatrixOrtho(-right, right, -top, top, RL_CULL_DISTANCE_NEAR,
+                             RL_CULL_DISTANCE_FAR);
+  }
+  // NOTE: raymath multiplies the other way round, this is projection * view
+  Matrix clip = MatrixMultiply(GetCameraMatrix(camera), projection);
+
+  // Rows of the clip matrix, the w row plus and minus each of the others
+  // give the left, right, bottom, top, near and far planes
+  Vector4 rows[4] = {
+      {clip.m0, clip.m4, clip.m8, clip.m12},
+      {clip.m1, clip.m5, clip.m9, clip.m13},
+      {clip.m2, clip.m6, clip.m10, clip.m14},
+      {clip.m3, clip.m7, clip.m11, clip.m15},
+  };
+  for (int i = 0; i < 3; i++) {
+    Vector4 row = rows[i];
+    Vector4 w = rows[3];
+    planes[2 * i] = NormalizePlane(
+        (Vector4){w.x + row.x, w.y + row.y, w.z + row.z, w.w + row.w});
+    planes[2 * i + 1] = NormalizePlane(
+        (Vector4){w.x - row.x, w.y - row.y, w.z - row.z, w.w - row.w});
+  }
+
+  playField = field;
+  stats = (ViewCullingStats){0};
+}
+
+bool IsSphereVisible(Vector3 center, float radius) {
+  bool visible =
+      (center.x + radius >= playField.x) &&
+      (center.x - radius <= playField.x + playField.width) &&
+      (center.z + radius >= playField.y) &&
+      (center.z - radius <= playField.y + playField.height);
+
+  for (int i = 0; (i < 6) && visible; i++) {
+    float distance = planes[i].x * center.x + planes[i].y * center.y +
+                     planes[i].z * center.z + planes[i].w;
+    visible = (distance >= -radius);
+  }
+
+  if (visible)
+    stats.drawn++;
+  else
+    stats.culled++;
+  return visible;
+}
+
+ViewCullingStats GetViewCullingStats(void) { return stats; }
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+// Unit normal, so plane distances compare directly with a radius
+static Vector4 NormalizePlane(Vector4 plane) {
+  float length =
+      sqrtf(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+  if (length == 0.0f)
+    return plane;
+
+  return (Vector4){plane.x / length, plane.y / length, plane.z / length,
+                   plane.w / length};
+}
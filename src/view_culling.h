@@ -0,0 +1,45 @@
+/**********************************************************************************************
+ *
+ *   View Culling - Skip entities the camera cannot see before drawing them
+ *
+ *   BeginViewCulling() takes the six frustum planes from the same view and
+ *   projection BeginMode3D() sets up for the camera, plus the play-field
+ *   rectangle in world x/z. IsSphereVisible() then rejects a bounding sphere
+ *   that lies entirely outside either one, so entities that drifted off the
+ *   field or out of view cost one test instead of a draw. The test is
+ *   conservative: a sphere straddling a plane is drawn.
+ *
+ *   Counts are kept from one BeginViewCulling() to the next.
+ *
+ **********************************************************************************************/
+
+#ifndef VIEW_CULLING_H
+#define VIEW_CULLING_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct ViewCullingStats {
+  int drawn;  // Spheres that passed both tests
+  int culled; // Spheres outside the frustum or the play field
+} ViewCullingStats;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//----------------------------------------------------------------------------------
+// View Culling Functions Declaration
+//----------------------------------------------------------------------------------
+// field is in world x/z: x and y are its minimum corner
+void BeginViewCulling(Camera3D camera, float aspect, Rectangle field);
+bool IsSphereVisible(Vector3 center, float radius);
+ViewCullingStats GetViewCullingStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VIEW_CULLING_H
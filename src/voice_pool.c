@@ -0,0 +1,139 @@
+/**********************************************************************************************
+ *
+ *   Voice Pool - Overlapping sound effects from a fixed set of voices
+ *
+ *   See voice_pool.h for how voices are picked and stolen.
+ *
+ **********************************************************************************************/
+
+#include "voice_pool.h"
+#include "raylib.h"
+#include "resource_tracker.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct Voice {
+  Sound alias;
+  int priority;         // Of the sound it last started
+  unsigned int started; // Start order, lower is older
+} Voice;
+
+typedef struct VoiceEffect {
+  Voice voices[MAX_EFFECT_VOICES];
+  int voiceCount;
+  int maxPerFrame;
+  int startedThisFrame;
+} VoiceEffect;
+
+//----------------------------------------------------------------------------------
+// Module Variables Definition (local)
+//----------------------------------------------------------------------------------
+static VoiceEffect effects[MAX_VOICE_EFFECTS] = {0};
+static int effectCount = 0;
+static unsigned int nextStart = 0;
+static VoicePoolStats stats = {0};
+
+//----------------------------------------------------------------------------------
+// Voice Pool Functions Definition
+//----------------------------------------------------------------------------------
+
+int LoadVoiceEffect(Sound sound, int voiceCount, int maxPerFrame) {
+  if (effectCount == MAX_VOICE_EFFECTS) {
+    TraceLog(LOG_WARNING, "VOICES: Pool full, effect not loaded");
+    return VOICE_EFFECT_INVALID;
+  }
+  if (sound.stream.buffer == NULL)
+    return VOICE_EFFECT_INVALID;
+
+  if (voiceCount < 1)
+    voiceCount = 1;
+  if (voiceCount > MAX_EFFECT_VOICES)
+    voiceCount = MAX_EFFECT_VOICES;
+
+  VoiceEffect *effect = &effects[effectCount];
+  *effect = (VoiceEffect){.voiceCount = voiceCount, .maxPerFrame = maxPerFrame};
+  for (int i = 0; i < voiceCount; i++) {
+    Sound alias = LoadSoundAlias(sound);
+    TrackResource(RESOURCE_SOUND, (size_t)alias.stream.buffer, 0, "voice");
+    effect->voices[i].alias = alias;
+  }
+
+  stats.voices += voiceCount;
+  return effectCount++;
+}
+
+void UnloadVoicePool(void) {
+  for (int e = 0; e < effectCount; e++) {
+    for (int i = 0; i < effects[e].voiceCount; i++) {
+      Sound alias = effects[e].voices[i].alias;
+      UntrackResource(RESOURCE_SOUND, (size_t)alias.stream.buffer);
+      UnloadSoundAlias(alias);
+    }
+  }
+
+  TraceLog(LOG_INFO,
+           "VOICES: %d started, %d stolen, %d rate limited, %d outranked",
+           stats.started, stats.stolen, stats.limited, stats.outranked);
+  effectCount = 0;
+  stats = (VoicePoolStats){0};
+}
+
+void BeginVoiceFrame(void) {
+  for (int e = 0; e < effectCount; e++)
+    effects[e].startedThisFrame = 0;
+}
+
+bool PlayVoice(int effect, int priority, float volume, float pitch) {
+  if ((effect < 0) || (effect >= effectCount))
+    return false;
+
+  VoiceEffect *fx = &effects[effect];
+  if ((fx->maxPerFrame > 0) && (fx->startedThisFrame >= fx->maxPerFrame)) {
+    stats.limited++;
+    return false;
+  }
+
+  // First idle voice, else the lowest priority, oldest busy one
+  Voice *voice = NULL;
+  Voice *victim = NULL;
+  for (int i = 0; (i < fx->voiceCount) && (voice == NULL); i++) {
+    Voice *candidate = &fx->voices[i];
+    if (!IsSoundPlaying(candidate->alias))
+      voice = candidate;
+    else if ((victim == NULL) || (candidate->priority < victim->priority) ||
+             ((candidate->priority == victim->priority) &&
+              (candidate->started < victim->started)))
+      victim = candidate;
+  }
+
+  if (voice == NULL) {
+    if (victim->priority > priority) {
+      stats.outranked++;
+      return false;
+    }
+    voice = victim; // NOTE: PlaySound() restarts a playing voice
+    stats.stolen++;
+  }
+
+  SetSoundVolume(voice->alias, volume);
+  SetSoundPitch(voice->alias, pitch);
+  PlaySound(voice->alias);
+  voice->priority = priority;
+  voice->started = nextStart++;
+
+  fx->startedThisFrame++;
+  stats.started++;
+  return true;
+}
+
+VoicePoolStats GetVoicePoolStats(void) {
+  VoicePoolStats current = stats;
+  current.playing = 0;
+  for (int e = 0; e < effectCount; e++) {
+    for (int i = 0; i < effects[e].voiceCount; i++)
+      current.playing += IsSoundPlaying(effects[e].voices[i].alias);
+  }
+
+  return current;
+}
@@ -0,0 +1,64 @@
+/**********************************************************************************************
+ *
+ *   Voice Pool - Overlapping sound effects from a fixed set of voices
+ *
+ *   LoadVoiceEffect() gives an effect a fixed number of voices up front,
+ *   sound aliases sharing the sample data of one loaded Sound, so playing
+ *   never loads, copies or allocates anything. PlayVoice() takes an idle
+ *   voice; when every voice of the effect is busy it steals the one with the
+ *   lowest priority, the oldest among equals, unless that priority is above
+ *   the new sound's, in which case the new sound is dropped.
+ *
+ *   Each effect also starts at most maxPerFrame sounds between two
+ *   BeginVoiceFrame() calls, so a burst of hits in a single frame does not
+ *   restart every voice at once; the rest are dropped and counted.
+ *
+ *   The source Sound stays with the caller and must outlive the pool.
+ *
+ **********************************************************************************************/
+
+#ifndef VOICE_POOL_H
+#define VOICE_POOL_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define MAX_VOICE_EFFECTS 8
+#define MAX_EFFECT_VOICES 32
+#define VOICE_EFFECT_INVALID -1
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct VoicePoolStats {
+  int voices;    // Loaded, across all effects
+  int playing;   // Voices still playing right now
+  int started;   // Sounds played, since the pool was loaded
+  int stolen;    // Of those, how many cut off an older voice
+  int limited;   // Dropped by the per-frame limit
+  int outranked; // Dropped because every busy voice had a higher priority
+} VoicePoolStats;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//----------------------------------------------------------------------------------
+// Voice Pool Functions Declaration
+//----------------------------------------------------------------------------------
+// VOICE_EFFECT_INVALID when the pool is full or the sound did not load;
+// maxPerFrame 0 means no limit
+int LoadVoiceEffect(Sound sound, int voiceCount, int maxPerFrame);
+void UnloadVoicePool(void); // Every effect, the source sounds are kept
+
+void BeginVoiceFrame(void); // Resets the per-frame limits
+bool PlayVoice(int effect, int priority, float volume, float pitch);
+VoicePoolStats GetVoicePoolStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VOICE_POOL_H